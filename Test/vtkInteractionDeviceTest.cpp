@@ -18,7 +18,9 @@
 
 
 #include <vtkActor.h>
+#include <vtkClusterDeviceInteractor.h>
 #include <vtkConeSource.h>
+#include <vtkDeviceCamera.h>
 #include <vtkDeviceInteractor.h>
 #include <vtkInteractionDeviceManager.h>
 #include <vtkInteractorStyleTrackballCamera.h>
@@ -39,6 +41,12 @@
 // 0 for VRPN tracker, 1 for Renci multi-touch, 2 for VRPN wiimote
 int mode = 0;
 
+// 0 for a single node, 1 for a cluster master, 2 for a cluster slave
+int clusterMode = 0;
+
+// Number of slaves the cluster master waits for
+int numberOfSlaves = 1;
+
 
 int main(int argc, char* argv[])
 {
@@ -75,7 +83,6 @@ int main(int argc, char* argv[])
     device1 = vtkVRPNTracker::New();
     vtkVRPNTracker* tracker = (vtkVRPNTracker*)device1;
     tracker->SetDeviceName("tracker@localhost");
-    tracker->Initialize();
 
     // A vtkDeviceInteractorStyle, such as vtkVRPNTrackerStyleCamera, listens for events from 
     // vtkInteractionDevices and performs interactions based on these events.
@@ -83,6 +90,11 @@ int main(int argc, char* argv[])
     vtkVRPNTrackerStyleCamera* trackerStyleCamera = (vtkVRPNTrackerStyleCamera*)deviceStyle;
     trackerStyleCamera->SetTracker(tracker);
     trackerStyleCamera->SetRenderer(renderer);
+
+    // A vtkDeviceCamera lets the style update the camera in one step
+    vtkDeviceCamera* camera = vtkDeviceCamera::New();
+    renderer->SetActiveCamera(camera);
+    camera->Delete();
     }
   else if (mode == 1)
     {
@@ -91,7 +103,6 @@ int main(int argc, char* argv[])
     vtkRenciMultiTouch* multiTouch = (vtkRenciMultiTouch*)device1;
     multiTouch->SetHostName("127.0.0.1");
     multiTouch->SetPort(50003);
-    multiTouch->Initialize();
 
     // A vtkDeviceInteractorStyle, such as vtkRenciMultiTouchStyleCamera, listens for events from 
     // vtkInteractionDevices and performs interactions based on these events.                
@@ -106,18 +117,15 @@ int main(int argc, char* argv[])
     device1 = vtkVRPNAnalog::New();
     vtkVRPNAnalog* analog = (vtkVRPNAnalog*)device1;
     analog->SetDeviceName("wiimote@localhost");
-    analog->Initialize();
 
     // A vtkInteractionDevice, such as a vtkVRPNAnalogOutput, communicates with an external device
     analogOutput = vtkVRPNAnalogOutput::New();
     analogOutput->SetDeviceName("wiimote@localhost");
-    analogOutput->Initialize();
 
     // A vtkInteractionDevice, such as a vtkVRPNButton, communicates with an external device
     device2 = vtkVRPNButton::New();
     vtkVRPNButton* button = (vtkVRPNButton*)device2;
     button->SetDeviceName("wiimote@localhost");
-    button->Initialize();
 
     // A vtkDeviceInteractorStyle, such as vtkVRPNWiiMoteStyleCamera, listens for events from 
     // vtkInteractionDevices and performs interactions based on these events.
@@ -132,12 +140,37 @@ int main(int argc, char* argv[])
   // A vtkDeviceInteractor is a container for vtkInteractionDevices and
   // vtkDeviceInteractorStyles that is used by the platform-specific subclasses
   // of vtkRenderWindowInteractor returned by vtkInteractionDeviceManager.
-  vtkDeviceInteractor* deviceInteractor = vtkDeviceInteractor::New();
+  vtkDeviceInteractor* deviceInteractor = NULL;
+  if (clusterMode == 0)
+    {
+    deviceInteractor = vtkDeviceInteractor::New();
+    }
+  else
+    {
+    // A vtkClusterDeviceInteractor shares the master's device input with 
+    // the slaves.  Set the number of slaves to wait for on the master.
+    vtkClusterDeviceInteractor* clusterInteractor = vtkClusterDeviceInteractor::New();
+    if (clusterMode == 1) 
+      {
+      clusterInteractor->SetModeToMaster();
+      clusterInteractor->SetNumberOfSlaves(numberOfSlaves);
+      }
+    else 
+      {
+      clusterInteractor->SetModeToSlave();
+      }
+    deviceInteractor = clusterInteractor;
+    }
   deviceInteractor->AddInteractionDevice(device1);
   deviceInteractor->AddInteractionDevice(device2);
   deviceInteractor->AddInteractionDevice(analogOutput);
   deviceInteractor->AddDeviceInteractorStyle(deviceStyle);
 
+  // Initialize all devices in parallel, waiting up to five seconds.  Devices
+  // that take longer keep connecting in the background, and devices that 
+  // lose their connection are reinitialized automatically.
+  deviceInteractor->InitializeDevices(5.0);
+
   // A vtkInteractionDeviceManager returns a platform-specific subclass of 
   // vtkRenderWindowInteractor that interfaces with external devices via
   // a vtkDeviceInteractor
@@ -0,0 +1,572 @@
+/*=========================================================================
+
+  Name:        vtkClusterDeviceInteractor.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkClusterDeviceInteractor.h"
+
+#include "vtkDeviceStateStream.h"
+#include "vtkInteractionDevice.h"
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+#include "vtkstd/vector"
+
+#include <math.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int vtkSocketLength;
+#define vtkCloseSocket closesocket
+#define vtkGetProcessId GetCurrentProcessId
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef socklen_t vtkSocketLength;
+#define vtkCloseSocket close
+#define vtkGetProcessId getpid
+#endif
+
+// Packet header fields, written in host byte order.  A receiver with the 
+// other byte order sees a byte-swapped magic number.
+#define VTK_CLUSTER_MAGIC 0x56544453
+#define VTK_CLUSTER_VERSION 5
+
+// Packet types
+#define VTK_CLUSTER_STATE 1
+#define VTK_CLUSTER_ACK 2
+
+// Largest UDP payload
+#define VTK_CLUSTER_MAX_PACKET 65507
+
+class vtkClusterDeviceInteractorInternals
+{
+public:
+  vtkClusterDeviceInteractorInternals()
+    {
+    this->Socket = -1;
+    this->Session = 0;
+    this->NodeId = 0;
+    this->Buffer.resize(VTK_CLUSTER_MAX_PACKET);
+    memset(&this->GroupAddress, 0, sizeof(this->GroupAddress));
+    }
+
+  int Socket;
+
+  // Master:  identifies this run, so slaves notice a restarted master
+  int Session;
+
+  // Slave:  identifies this slave in acknowledgements.  Slaves on one 
+  // host all send from the shared group port, so their addresses can't 
+  // tell them apart.
+  int NodeId;
+
+  // Master:  the group to send to.  Slaves reply to the sender address.
+  sockaddr_in GroupAddress;
+
+  // Master:  node ids of the slaves that have acknowledged the current 
+  // frame
+  vtkstd::vector<int> Acknowledged;
+
+  // Receive buffer
+  vtkstd::vector<unsigned char> Buffer;
+
+  // Wait for the socket to become readable, until the deadline
+  int WaitForPacket(double deadline);
+};
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractorInternals::WaitForPacket(double deadline)
+{
+  double remaining = deadline - vtkTimerLog::GetUniversalTime();
+  if (remaining < 0.0) remaining = 0.0;
+
+  timeval timeout;
+  timeout.tv_sec = static_cast<long>(floor(remaining));
+  timeout.tv_usec = static_cast<long>((remaining - floor(remaining)) * 1e6);
+
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  FD_SET(this->Socket, &readSet);
+
+  return select(this->Socket + 1, &readSet, NULL, NULL, &timeout) > 0;
+}
+
+// Write the packet header
+static void WriteHeader(vtkDeviceStateStream* stream, int type, int session, unsigned int frame)
+{
+  stream->WriteInt(VTK_CLUSTER_MAGIC);
+  stream->WriteInt(VTK_CLUSTER_VERSION);
+  stream->WriteInt(type);
+  stream->WriteInt(session);
+  stream->WriteInt(static_cast<int>(frame));
+}
+
+// Read the packet header, returning 0 if the packet isn't ours
+static int ReadHeader(vtkDeviceStateStream* stream, int& type, int& session, unsigned int& frame)
+{
+  if (stream->ReadInt() != VTK_CLUSTER_MAGIC) return 0;
+  if (stream->ReadInt() != VTK_CLUSTER_VERSION) return 0;
+
+  type = stream->ReadInt();
+  session = stream->ReadInt();
+  frame = static_cast<unsigned int>(stream->ReadInt());
+
+  return !stream->GetError();
+}
+
+vtkCxxRevisionMacro(vtkClusterDeviceInteractor, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkClusterDeviceInteractor);
+
+//----------------------------------------------------------------------------
+vtkClusterDeviceInteractor::vtkClusterDeviceInteractor() 
+{
+  this->Mode = Master;
+  this->GroupAddress = NULL;
+  this->SetGroupAddress("239.255.42.99");
+  this->Port = 7643;
+  this->NumberOfSlaves = 0;
+  this->Timeout = 0.5;
+
+  this->FrameNumber = 0;
+
+  this->PacketStream = vtkDeviceStateStream::New();
+  this->DeviceStream = vtkDeviceStateStream::New();
+
+  this->ClusterInternals = new vtkClusterDeviceInteractorInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkClusterDeviceInteractor::~vtkClusterDeviceInteractor()
+{
+  this->CloseSocket();
+
+  this->SetGroupAddress(NULL);
+
+  this->PacketStream->Delete();
+  this->DeviceStream->Delete();
+
+  delete this->ClusterInternals;
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::InitializeDevices(double timeout)
+{
+  if (!this->OpenSocket()) return 0;
+
+  if (this->Mode == Master)
+    {
+    return this->Superclass::InitializeDevices(timeout);
+    }
+
+  // Slaves only mirror the master's devices
+  for (int i = 0; i < this->GetNumberOfInteractionDevices(); i++)
+    {
+    this->GetInteractionDevice(i)->ReplicaOn();
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkClusterDeviceInteractor::Update()
+{
+  if (this->ClusterInternals->Socket < 0)
+    {
+    this->Superclass::Update();
+    return;
+    }
+
+  if (this->Mode == Master)
+    {
+    this->ReceiveUpdates();
+    this->SendState();
+    }
+  else
+    {
+    this->ClearUpdatedDevices();
+    this->ReceiveState();
+    }
+
+  this->InvokeEvents();
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::IsFrameDue()
+{
+  if (this->ClusterInternals->Socket < 0) return this->Superclass::IsFrameDue();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::IsRenderDue(vtkRenderWindow* window)
+{
+  if (this->ClusterInternals->Socket < 0) return this->Superclass::IsRenderDue(window);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::IsRefinementDue()
+{
+  if (this->ClusterInternals->Socket < 0) return this->Superclass::IsRefinementDue();
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::OpenSocket()
+{
+  this->CloseSocket();
+
+#ifdef WIN32
+  WSADATA data;
+  if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+    vtkErrorMacro(<<"Can't initialize Winsock.");
+    return 0;
+    }
+#endif
+
+  int s = static_cast<int>(socket(AF_INET, SOCK_DGRAM, 0));
+  if (s < 0)
+    {
+    vtkErrorMacro(<<"Can't create socket.");
+    return 0;
+    }
+
+  sockaddr_in& group = this->ClusterInternals->GroupAddress;
+  memset(&group, 0, sizeof(group));
+  group.sin_family = AF_INET;
+  group.sin_port = htons(static_cast<unsigned short>(this->Port));
+  group.sin_addr.s_addr = inet_addr(this->GroupAddress ? this->GroupAddress : "");
+
+  if (group.sin_addr.s_addr == INADDR_NONE)
+    {
+    vtkErrorMacro(<<"Invalid group address " << (this->GroupAddress ? this->GroupAddress : "(none)") << ".");
+    vtkCloseSocket(s);
+    return 0;
+    }
+
+  if (this->Mode == Master)
+    {
+    // Stay on the local network, and loop packets back so slaves can run
+    // on this host
+    unsigned char ttl = 1;
+    unsigned char loop = 1;
+    setsockopt(s, IPPROTO_IP, IP_MULTICAST_TTL, (const char*)&ttl, sizeof(ttl));
+    setsockopt(s, IPPROTO_IP, IP_MULTICAST_LOOP, (const char*)&loop, sizeof(loop));
+
+    // Any time-varying value will do
+    this->ClusterInternals->Session = static_cast<int>(fmod(vtkTimerLog::GetUniversalTime() * 1000.0, 2147483647.0));
+    }
+  else
+    {
+    // Distinct for slaves started at the same time on one host
+    this->ClusterInternals->NodeId = static_cast<int>(fmod(vtkTimerLog::GetUniversalTime() * 1000.0, 2147483647.0)) ^ 
+                              (static_cast<int>(vtkGetProcessId()) << 16);
+
+    // Let several slaves share the port on one host
+    int reuse = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = group.sin_port;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(s, (sockaddr*)&local, sizeof(local)) < 0)
+      {
+      vtkErrorMacro(<<"Can't bind to port " << this->Port << ".");
+      vtkCloseSocket(s);
+      return 0;
+      }
+
+    ip_mreq membership;
+    membership.imr_multiaddr = group.sin_addr;
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+
+    if (setsockopt(s, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&membership, sizeof(membership)) < 0)
+      {
+      vtkErrorMacro(<<"Can't join multicast group " << this->GroupAddress << ".");
+      vtkCloseSocket(s);
+      return 0;
+      }
+    }
+
+  this->ClusterInternals->Socket = s;
+  this->FrameNumber = 0;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkClusterDeviceInteractor::CloseSocket()
+{
+  if (this->ClusterInternals->Socket < 0) return;
+
+  vtkCloseSocket(this->ClusterInternals->Socket);
+  this->ClusterInternals->Socket = -1;
+
+#ifdef WIN32
+  WSACleanup();
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkClusterDeviceInteractor::SendState()
+{
+  vtkClusterDeviceInteractorInternals* internals = this->ClusterInternals;
+
+  this->FrameNumber++;
+
+  // Build the packet
+  vtkDeviceStateStream* packet = this->PacketStream;
+  packet->Reset();
+  WriteHeader(packet, VTK_CLUSTER_STATE, internals->Session, this->FrameNumber);
+
+  // Find the index of each updated device among the added devices, 
+  // which is the same on every node
+  int numDevices = this->GetNumberOfInteractionDevices();
+  vtkstd::vector<int> indices;
+
+  for (int i = 0; i < this->GetNumberOfUpdatedDevices(); i++)
+    {
+    vtkInteractionDevice* device = this->GetUpdatedDevice(i);
+
+    int index = 0;
+    while (index < numDevices && this->GetInteractionDevice(index) != device) index++;
+
+    if (index == numDevices)
+      {
+      vtkErrorMacro(<<"Updated device " << device << " was not added, so its state can't be sent.");
+      continue;
+      }
+
+    indices.push_back(index);
+    }
+
+  packet->WriteInt(static_cast<int>(indices.size()));
+
+  for (unsigned int i = 0; i < indices.size(); i++)
+    {
+    vtkInteractionDevice* device = this->GetInteractionDevice(indices[i]);
+
+    this->DeviceStream->Reset();
+    device->WriteState(this->DeviceStream);
+
+    packet->WriteInt(indices[i]);
+    packet->WriteInt(this->DeviceStream->GetSize());
+    packet->WriteBytes(this->DeviceStream->GetData(), this->DeviceStream->GetSize());
+    }
+
+  if (packet->GetSize() > VTK_CLUSTER_MAX_PACKET)
+    {
+    vtkErrorMacro(<<"Device state for frame " << this->FrameNumber << " is too large to send.");
+    return;
+    }
+
+  // Send, resending a few times within the timeout if acknowledgements are
+  // slow to arrive
+  internals->Acknowledged.clear();
+
+  double deadline = vtkTimerLog::GetUniversalTime() + this->Timeout;
+  double resendInterval = this->Timeout / 4.0;
+
+  while (1)
+    {
+    sendto(internals->Socket, (const char*)packet->GetData(), packet->GetSize(), 0,
+           (sockaddr*)&internals->GroupAddress, sizeof(internals->GroupAddress));
+
+    double resendTime = vtkTimerLog::GetUniversalTime() + resendInterval;
+    if (resendTime > deadline) resendTime = deadline;
+
+    if (this->WaitForAcknowledgements(resendTime)) return;
+
+    if (vtkTimerLog::GetUniversalTime() >= deadline)
+      {
+      vtkWarningMacro(<<"Only " << internals->Acknowledged.size() << " of " << this->NumberOfSlaves 
+                      << " slaves acknowledged frame " << this->FrameNumber << ".");
+      return;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::WaitForAcknowledgements(double deadline)
+{
+  vtkClusterDeviceInteractorInternals* internals = this->ClusterInternals;
+
+  while (static_cast<int>(internals->Acknowledged.size()) < this->NumberOfSlaves)
+    {
+    if (!internals->WaitForPacket(deadline)) return 0;
+
+    sockaddr_in sender;
+    vtkSocketLength senderLength = sizeof(sender);
+    int size = recvfrom(internals->Socket, (char*)&internals->Buffer[0], static_cast<int>(internals->Buffer.size()), 0,
+                        (sockaddr*)&sender, &senderLength);
+    if (size <= 0) continue;
+
+    this->PacketStream->SetData(&internals->Buffer[0], size);
+
+    int type, session;
+    unsigned int frame;
+    if (!ReadHeader(this->PacketStream, type, session, frame) ||
+        type != VTK_CLUSTER_ACK || session != internals->Session || frame != this->FrameNumber)
+      {
+      continue;
+      }
+
+    int node = this->PacketStream->ReadInt();
+    if (this->PacketStream->GetError()) continue;
+
+    // Count each slave once, as resends are acknowledged again
+    int found = 0;
+    for (unsigned int i = 0; i < internals->Acknowledged.size(); i++)
+      {
+      if (internals->Acknowledged[i] == node)
+        {
+        found = 1;
+        break;
+        }
+      }
+    if (!found) internals->Acknowledged.push_back(node);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::ReceiveState()
+{
+  vtkClusterDeviceInteractorInternals* internals = this->ClusterInternals;
+
+  double deadline = vtkTimerLog::GetUniversalTime() + this->Timeout;
+
+  while (internals->WaitForPacket(deadline))
+    {
+    sockaddr_in sender;
+    vtkSocketLength senderLength = sizeof(sender);
+    int size = recvfrom(internals->Socket, (char*)&internals->Buffer[0], static_cast<int>(internals->Buffer.size()), 0,
+                        (sockaddr*)&sender, &senderLength);
+    if (size <= 0) continue;
+
+    this->PacketStream->SetData(&internals->Buffer[0], size);
+
+    int type, session;
+    unsigned int frame;
+    if (!ReadHeader(this->PacketStream, type, session, frame) || type != VTK_CLUSTER_STATE) 
+      {
+      continue;
+      }
+
+    // Start over if the master has restarted
+    if (session != internals->Session)
+      {
+      internals->Session = session;
+      this->FrameNumber = 0;
+      }
+
+    // Acknowledge new frames and resends of the current one, so the master
+    // stops waiting
+    int isNew = frame > this->FrameNumber;
+    if (isNew || frame == this->FrameNumber)
+      {
+      vtkDeviceStateStream* ack = this->DeviceStream;
+      ack->Reset();
+      WriteHeader(ack, VTK_CLUSTER_ACK, session, frame);
+      ack->WriteInt(internals->NodeId);
+      sendto(internals->Socket, (const char*)ack->GetData(), ack->GetSize(), 0,
+             (sockaddr*)&sender, senderLength);
+      }
+
+    if (!isNew) continue;
+
+    this->FrameNumber = frame;
+
+    return this->ApplyState();
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkClusterDeviceInteractor::ApplyState()
+{
+  // The header has already been read
+  vtkDeviceStateStream* packet = this->PacketStream;
+
+  int numUpdated = packet->ReadInt();
+  int truncated = packet->GetError();
+
+  for (int i = 0; i < numUpdated && !truncated; i++)
+    {
+    int index = packet->ReadInt();
+    int deviceSize = packet->ReadInt();
+    int position = packet->GetPosition();
+
+    if (packet->GetError() || deviceSize < 0 || position + deviceSize > packet->GetSize()) 
+      {
+      truncated = 1;
+      break;
+      }
+
+    vtkInteractionDevice* device = this->GetInteractionDevice(index);
+    if (device == NULL)
+      {
+      vtkErrorMacro(<<"Frame " << this->FrameNumber << " has state for device " << index 
+                    << ", but only " << this->GetNumberOfInteractionDevices() << " devices were added.");
+      return 0;
+      }
+
+    // Read from a stream of its own, so a device that reads too little or 
+    // too much can't throw off the rest of the packet
+    this->DeviceStream->SetData(packet->GetData() + position, deviceSize);
+    device->ReadState(this->DeviceStream);
+    if (this->DeviceStream->GetError())
+      {
+      vtkErrorMacro(<<"Bad state for device " << index << " in frame " << this->FrameNumber << ".");
+      }
+
+    this->AddUpdatedDevice(device);
+
+    packet->SetPosition(position + deviceSize);
+    }
+
+  if (truncated)
+    {
+    vtkErrorMacro(<<"Frame " << this->FrameNumber << " is truncated.");
+    return 0;
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkClusterDeviceInteractor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Mode: " << (this->Mode == Master ? "Master" : "Slave") << "\n";
+  os << indent << "GroupAddress: " << (this->GroupAddress ? this->GroupAddress : "(none)") << "\n";
+  os << indent << "Port: " << this->Port << "\n";
+  os << indent << "NumberOfSlaves: " << this->NumberOfSlaves << "\n";
+  os << indent << "Timeout: " << this->Timeout << "\n";
+  os << indent << "FrameNumber: " << this->FrameNumber << "\n";
+}
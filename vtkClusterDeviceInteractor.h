@@ -0,0 +1,160 @@
+/*=========================================================================
+
+  Name:        vtkClusterDeviceInteractor.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkClusterDeviceInteractor
+// .SECTION Description
+// vtkClusterDeviceInteractor shares device input across the nodes of a 
+// render cluster, so every node renders the same input on the same frame.
+//
+// The master polls its devices as usual, then multicasts a snapshot of 
+// the state of every device updated this frame over UDP, tagged with a 
+// frame number.  Slaves don't connect to any devices.  Instead, each 
+// Update() waits for the next snapshot, applies it to the devices with 
+// vtkInteractionDevice::ReadState(), acknowledges the frame number, and 
+// invokes events as if the devices had been updated locally.  The master 
+// waits for all slaves to acknowledge a frame before invoking its own 
+// events, resending the snapshot if acknowledgements are slow.
+//
+// All nodes must add the same types of devices in the same order, and 
+// share byte order.  Slaves don't need device names, host names, etc.
+//
+// To test on one machine, run a master and several slaves with the same
+// group address and port.  Multicast packets are looped back to the 
+// sending host, but Linux needs a multicast route, e.g. 
+// "ip route add 224.0.0.0/4 dev lo" if there is no default route.
+
+// .SECTION see also
+// vtkDeviceInteractor vtkDeviceStateStream
+
+#ifndef __vtkClusterDeviceInteractor_h
+#define __vtkClusterDeviceInteractor_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkDeviceInteractor.h"
+
+class vtkDeviceStateStream;
+
+// Holds socket addresses and vtkstd member variables, which must be hidden
+class vtkClusterDeviceInteractorInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkClusterDeviceInteractor : public vtkDeviceInteractor
+{
+public:
+  static vtkClusterDeviceInteractor* New();
+  vtkTypeRevisionMacro(vtkClusterDeviceInteractor,vtkDeviceInteractor);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Open the cluster connection.  The master then initializes its devices
+  // as usual, while slaves set their devices up as replicas.
+  virtual int InitializeDevices(double timeout);
+
+  // Description:
+  // Update the devices on the master, or receive their state on a slave, 
+  // then invoke events
+  virtual void Update();
+
+  // Description:
+  // Nodes update and render every frame once connected, so they stay in 
+  // step.  The master's frame rate is set by the slowest node's 
+  // acknowledgements.
+  virtual int IsFrameDue();
+  virtual int IsRenderDue(vtkRenderWindow* window);
+
+  // Description:
+  // Nodes don't refine once connected, as each would decide it is idle 
+  // at a different time
+  virtual int IsRefinementDue();
+
+  // Enumeration for cluster modes
+  //BTX
+  enum ClusterModes {
+      Master = 0,
+      Slave
+  };
+  //ETX
+
+  // Description:
+  // Set/get whether this node is the master or a slave.  Must be set 
+  // before InitializeDevices().
+  vtkSetClampMacro(Mode,int,Master,Slave);
+  vtkGetMacro(Mode,int);
+  void SetModeToMaster() { this->SetMode(Master); }
+  void SetModeToSlave() { this->SetMode(Slave); }
+
+  // Description:
+  // Set/get the multicast group address and port
+  vtkSetStringMacro(GroupAddress);
+  vtkGetStringMacro(GroupAddress);
+  vtkSetMacro(Port,int);
+  vtkGetMacro(Port,int);
+
+  // Description:
+  // Set/get the number of slaves the master waits for each frame
+  vtkSetClampMacro(NumberOfSlaves,int,0,VTK_INT_MAX);
+  vtkGetMacro(NumberOfSlaves,int);
+
+  // Description:
+  // Set/get the time in seconds the master waits for acknowledgements, 
+  // and slaves wait for a snapshot, each frame.  Nodes carry on without 
+  // input for the frame after the timeout.
+  vtkSetClampMacro(Timeout,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(Timeout,double);
+
+  // Description:
+  // Get the number of the last frame sent or received
+  vtkGetMacro(FrameNumber,unsigned int);
+
+protected:
+  vtkClusterDeviceInteractor();
+  ~vtkClusterDeviceInteractor();
+
+  int Mode;
+  char* GroupAddress;
+  int Port;
+  int NumberOfSlaves;
+  double Timeout;
+
+  unsigned int FrameNumber;
+
+  // Streams for whole packets, and the state of one device
+  vtkDeviceStateStream* PacketStream;
+  vtkDeviceStateStream* DeviceStream;
+
+  vtkClusterDeviceInteractorInternals* ClusterInternals;
+
+  // Description:
+  // Open/close the socket for the current mode
+  int OpenSocket();
+  void CloseSocket();
+
+  // Description:
+  // Master:  send the state of the devices updated this frame, and wait 
+  // for the slaves to acknowledge it
+  void SendState();
+  int WaitForAcknowledgements(double deadline);
+
+  // Description:
+  // Slave:  wait for the next frame's state and apply it
+  int ReceiveState();
+  int ApplyState();
+
+private:
+  vtkClusterDeviceInteractor(const vtkClusterDeviceInteractor&);  // Not implemented.
+  void operator=(const vtkClusterDeviceInteractor&);  // Not implemented.
+};
+
+#endif
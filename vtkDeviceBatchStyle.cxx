@@ -0,0 +1,241 @@
+/*=========================================================================
+
+  Name:        vtkDeviceBatchStyle.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkDeviceBatchStyle.h"
+
+#include "vtkDeviceEventBatch.h"
+#include "vtkInteractionDevice.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenciMultiTouch.h"
+#include "vtkVRPNAnalog.h"
+#include "vtkVRPNButton.h"
+#include "vtkVRPNTracker.h"
+#include "vtkstd/vector"
+
+// A device, and its state at the end of the last frame, for finding what
+// changed.  Button transitions are taken from the device as they arrive 
+// instead, as a press and release within a frame leave no change.
+struct vtkDeviceBatchStyleEntry
+{
+  vtkInteractionDevice* Device;
+
+  // Whether the device invoked events this frame
+  int Updated;
+
+  // Tracker poses (position and rotation, 7 values per sensor) and 
+  // analog channels
+  vtkstd::vector<double> Poses;
+  vtkstd::vector<double> Channels;
+};
+
+class vtkDeviceBatchStyleInternals
+{
+public:
+  // Devices aren't referenced, as they reference the style
+  vtkstd::vector<vtkDeviceBatchStyleEntry> Devices;
+
+  int FindDevice(vtkInteractionDevice* device)
+    {
+    for (unsigned int i = 0; i < this->Devices.size(); i++)
+      {
+      if (this->Devices[i].Device == device) return static_cast<int>(i);
+      }
+    return -1;
+    }
+};
+
+vtkCxxRevisionMacro(vtkDeviceBatchStyle, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDeviceBatchStyle);
+
+//----------------------------------------------------------------------------
+vtkDeviceBatchStyle::vtkDeviceBatchStyle() 
+{
+  this->Batch = vtkDeviceEventBatch::New();
+  this->InvokeEmptyBatches = 0;
+
+  this->Internals = new vtkDeviceBatchStyleInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceBatchStyle::~vtkDeviceBatchStyle() 
+{
+  this->Batch->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::AddDevice(vtkInteractionDevice* device)
+{
+  if (device == NULL || this->Internals->FindDevice(device) >= 0) return;
+
+  vtkDeviceBatchStyleEntry entry;
+  entry.Device = device;
+  entry.Updated = 0;
+  this->Internals->Devices.push_back(entry);
+
+  // All events
+  device->AddDeviceInteractorStyle(this, ~0ul);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::RemoveDevice(vtkInteractionDevice* device)
+{
+  int index = this->Internals->FindDevice(device);
+  if (index < 0) return;
+
+  this->Internals->Devices.erase(this->Internals->Devices.begin() + index);
+
+  device->RemoveDeviceInteractorStyle(this);
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceBatchStyle::GetNumberOfDevices()
+{
+  return static_cast<int>(this->Internals->Devices.size());
+}
+
+//----------------------------------------------------------------------------
+vtkInteractionDevice* vtkDeviceBatchStyle::GetDevice(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfDevices()) return NULL;
+
+  return this->Internals->Devices[i].Device;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::OnEvent(vtkObject* caller, unsigned long eid, void*) 
+{
+  vtkInteractionDevice* device = vtkInteractionDevice::SafeDownCast(caller);
+  if (device) this->OnDeviceEvent(device, eid);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::OnDeviceEvent(vtkInteractionDevice* device, unsigned long eid) 
+{
+  int index = this->Internals->FindDevice(device);
+  if (index < 0) return;
+
+  this->Internals->Devices[index].Updated = 1;
+  this->Batch->SetNumberOfEvents(this->Batch->GetNumberOfEvents() + 1);
+
+  // Gestures are events rather than state, so record them as they come
+  vtkRenciMultiTouch* multiTouch = vtkRenciMultiTouch::SafeDownCast(device);
+  if (multiTouch && eid <= vtkRenciMultiTouch::ReleaseEvent)
+    {
+    this->Batch->AddGesture(index, static_cast<int>(eid), multiTouch->GetNumberOfTouchPoints());
+    }
+
+  // Likewise button transitions, which the device queues between events
+  vtkVRPNButton* button = vtkVRPNButton::SafeDownCast(device);
+  if (button && eid == vtkVRPNDevice::ButtonEvent)
+    {
+    for (int i = 0; i < button->GetNumberOfTransitions(); i++)
+      {
+      this->Batch->AddButtonTransition(index, button->GetTransitionButton(i), 
+                                       button->GetTransitionState(i));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::EndFrame() 
+{
+  for (unsigned int i = 0; i < this->Internals->Devices.size(); i++)
+    {
+    if (this->Internals->Devices[i].Updated) this->AddChanges(i);
+    this->Internals->Devices[i].Updated = 0;
+    }
+
+  if (!this->Batch->IsEmpty() || this->InvokeEmptyBatches)
+    {
+    this->OnFrame(this->Batch);
+    }
+
+  this->Batch->Reset();
+  this->Batch->SetFrameNumber(this->Batch->GetFrameNumber() + 1);
+
+  // Update other renderers after the handler has moved the camera
+  this->Superclass::EndFrame();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::OnFrame(vtkDeviceEventBatch* batch) 
+{
+  this->InvokeEvent(vtkDeviceBatchStyle::FrameEvent, batch);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::AddChanges(int index) 
+{
+  vtkDeviceBatchStyleEntry& entry = this->Internals->Devices[index];
+
+  vtkVRPNTracker* tracker = vtkVRPNTracker::SafeDownCast(entry.Device);
+  if (tracker)
+    {
+    int n = tracker->GetNumberOfSensors();
+    unsigned int size = static_cast<unsigned int>(n * 7);
+
+    // Everything is new after the number of sensors changes
+    int all = entry.Poses.size() != size;
+    entry.Poses.resize(size);
+
+    for (int i = 0; i < n; i++)
+      {
+      double* position = tracker->GetPosition(i);
+      double* rotation = tracker->GetRotation(i);
+      double* previous = &entry.Poses[i * 7];
+
+      int changed = all;
+      for (int j = 0; j < 3 && !changed; j++) changed = position[j] != previous[j];
+      for (int j = 0; j < 4 && !changed; j++) changed = rotation[j] != previous[j + 3];
+      if (!changed) continue;
+
+      this->Batch->AddSensor(index, i, position, rotation);
+
+      for (int j = 0; j < 3; j++) previous[j] = position[j];
+      for (int j = 0; j < 4; j++) previous[j + 3] = rotation[j];
+      }
+
+    return;
+    }
+
+  vtkVRPNAnalog* analog = vtkVRPNAnalog::SafeDownCast(entry.Device);
+  if (analog)
+    {
+    int n = analog->GetNumberOfChannels();
+    int all = static_cast<int>(entry.Channels.size()) != n;
+    entry.Channels.resize(n);
+
+    for (int i = 0; i < n; i++)
+      {
+      double value = analog->GetChannel(i);
+      if (!all && value == entry.Channels[i]) continue;
+
+      this->Batch->AddChannel(index, i, value);
+      entry.Channels[i] = value;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceBatchStyle::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "NumberOfDevices: " << this->GetNumberOfDevices() << "\n";
+  os << indent << "InvokeEmptyBatches: " << this->InvokeEmptyBatches << "\n";
+  os << indent << "Batch: " << this->Batch << "\n";
+}
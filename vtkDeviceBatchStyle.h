@@ -0,0 +1,110 @@
+/*=========================================================================
+
+  Name:        vtkDeviceBatchStyle.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDeviceBatchStyle
+// .SECTION Description
+// vtkDeviceBatchStyle collects the events of all its devices during a 
+// frame, then hands them over in one vtkDeviceEventBatch at the end of 
+// the frame.  Tracker sensors that moved, every button press/release, 
+// analog channels that changed and multi-touch gestures are gathered 
+// into arrays, so a handler runs once per frame rather than once per 
+// event.  
+//
+// This is meant for styles written in a wrapped language, where each 
+// callback crosses into the interpreter.  From Python, observe FrameEvent
+// (vtkCommand::UserEvent, so "UserEvent") and get the batch with 
+// GetBatch().  C++ subclasses can override OnFrame() instead.
+
+// .SECTION see also
+// vtkDeviceEventBatch vtkDeviceInteractorStyle
+
+#ifndef __vtkDeviceBatchStyle_h
+#define __vtkDeviceBatchStyle_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkDeviceInteractorStyle.h"
+
+#include "vtkCommand.h"  // For FrameEvent
+
+class vtkDeviceEventBatch;
+
+// Holds vtkstd member variables, which must be hidden
+class vtkDeviceBatchStyleInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceBatchStyle : public vtkDeviceInteractorStyle
+{
+public:
+  static vtkDeviceBatchStyle* New();
+  vtkTypeRevisionMacro(vtkDeviceBatchStyle,vtkDeviceInteractorStyle);
+  void PrintSelf(ostream&, vtkIndent); 
+
+  // Description:
+  // Record an event for the batch
+  virtual void OnEvent(vtkObject* caller, unsigned long eid, void* callData);
+  virtual void OnDeviceEvent(vtkInteractionDevice* device, unsigned long eid);
+
+  // Description:
+  // Add/remove devices to collect events from.  Devices are identified in
+  // the batch by the order they were added.
+  void AddDevice(vtkInteractionDevice*);
+  void RemoveDevice(vtkInteractionDevice*);
+  int GetNumberOfDevices();
+  vtkInteractionDevice* GetDevice(int i);
+
+  // Description:
+  // Build the batch for the frame and pass it to OnFrame()
+  virtual void EndFrame();
+
+  // Description:
+  // Get the batch for the current frame
+  vtkGetObjectMacro(Batch,vtkDeviceEventBatch);
+
+  // Description:
+  // Hand over batches in which nothing changed.  Off by default.
+  vtkSetMacro(InvokeEmptyBatches,int);
+  vtkGetMacro(InvokeEmptyBatches,int);
+  vtkBooleanMacro(InvokeEmptyBatches,int);
+
+  // Event invoked with the batch for each frame
+  //BTX
+  enum BatchStyleEventIds {
+      FrameEvent = vtkCommand::UserEvent
+  };
+  //ETX
+
+protected:
+  vtkDeviceBatchStyle();
+  ~vtkDeviceBatchStyle();
+
+  vtkDeviceEventBatch* Batch;
+  int InvokeEmptyBatches;
+
+  vtkDeviceBatchStyleInternals* Internals;
+
+  // Description:
+  // Act on the batch for the frame.  Invokes FrameEvent by default.
+  virtual void OnFrame(vtkDeviceEventBatch* batch);
+
+  // Description:
+  // Add the changes of a device since the last frame to the batch
+  void AddChanges(int index);
+
+private:
+  vtkDeviceBatchStyle(const vtkDeviceBatchStyle&);  // Not implemented.
+  void operator=(const vtkDeviceBatchStyle&);  // Not implemented.
+};
+
+#endif
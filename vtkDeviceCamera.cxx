@@ -0,0 +1,118 @@
+/*=========================================================================
+
+  Name:        vtkDeviceCamera.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkDeviceCamera.h"
+
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+
+vtkCxxRevisionMacro(vtkDeviceCamera, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDeviceCamera);
+
+//----------------------------------------------------------------------------
+vtkDeviceCamera::vtkDeviceCamera() 
+{
+  this->HasReferencePose = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceCamera::~vtkDeviceCamera() 
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceCamera::SetPose(const double position[3], const double focalPoint[3], const double viewUp[3]) 
+{
+  double up[3] = { viewUp[0], viewUp[1], viewUp[2] };
+  vtkMath::Normalize(up);
+
+  for (int i = 0; i < 3; i++)
+    {
+    this->Position[i] = position[i];
+    this->FocalPoint[i] = focalPoint[i];
+    this->ViewUp[i] = up[i];
+    }
+
+  // Do what SetPosition(), SetFocalPoint() and SetViewUp() each do, once
+  this->ComputeViewTransform();
+  this->ComputeDistance();
+  this->ComputeCameraLightTransform();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceCamera::SetReferencePose(const double position[3], const double focalPoint[3], const double viewUp[3]) 
+{
+  for (int i = 0; i < 3; i++)
+    {
+    this->ReferencePosition[i] = position[i];
+    this->ReferenceFocalPoint[i] = focalPoint[i];
+    this->ReferenceViewUp[i] = viewUp[i];
+    this->ReferenceBackward[i] = position[i] - focalPoint[i];
+    }
+
+  // Orthonormal camera axes
+  vtkMath::Normalize(this->ReferenceBackward);
+  vtkMath::Cross(viewUp, this->ReferenceBackward, this->ReferenceRight);
+  vtkMath::Normalize(this->ReferenceRight);
+  vtkMath::Cross(this->ReferenceBackward, this->ReferenceRight, this->ReferenceUp);
+
+  this->HasReferencePose = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceCamera::ResetReferencePose() 
+{
+  this->HasReferencePose = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceCamera::SetHeadOffset(const double offset[3]) 
+{
+  if (!this->HasReferencePose)
+    {
+    this->SetReferencePose(this->Position, this->FocalPoint, this->ViewUp);
+    }
+
+  double position[3];
+  for (int i = 0; i < 3; i++)
+    {
+    position[i] = this->ReferencePosition[i] + 
+                  offset[0] * this->ReferenceRight[i] + 
+                  offset[1] * this->ReferenceUp[i] + 
+                  offset[2] * this->ReferenceBackward[i];
+    }
+
+  this->SetPose(position, this->ReferenceFocalPoint, this->ReferenceViewUp);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceCamera::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "HasReferencePose: " << this->HasReferencePose << "\n";
+  if (this->HasReferencePose)
+    {
+    os << indent << "ReferencePosition: (" << this->ReferencePosition[0] << ", " 
+       << this->ReferencePosition[1] << ", " << this->ReferencePosition[2] << ")\n";
+    os << indent << "ReferenceFocalPoint: (" << this->ReferenceFocalPoint[0] << ", " 
+       << this->ReferenceFocalPoint[1] << ", " << this->ReferenceFocalPoint[2] << ")\n";
+    os << indent << "ReferenceViewUp: (" << this->ReferenceViewUp[0] << ", " 
+       << this->ReferenceViewUp[1] << ", " << this->ReferenceViewUp[2] << ")\n";
+    }
+}
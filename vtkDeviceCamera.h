@@ -0,0 +1,85 @@
+/*=========================================================================
+
+  Name:        vtkDeviceCamera.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDeviceCamera
+// .SECTION Description
+// vtkDeviceCamera is a camera that can be driven by a tracked device.  
+// Setting the position, focal point and view up of a vtkCamera one at a
+// time recomputes the view transform after each call.  SetPose() sets 
+// them all at once and recomputes the camera's matrices once.
+//
+// For fishtank VR, the camera can instead be fixed at a reference pose, 
+// with SetHeadOffset() moving the eye relative to it as the head moves.
+//
+// Use by setting it as the active camera of the renderer passed to a 
+// style, e.g. vtkVRPNTrackerStyleCamera.  Styles fall back to the 
+// vtkCamera setters for other cameras.
+
+// .SECTION see also
+// vtkVRPNTrackerStyleCamera
+
+#ifndef __vtkDeviceCamera_h
+#define __vtkDeviceCamera_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkOpenGLCamera.h"
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceCamera : public vtkOpenGLCamera
+{
+public:
+  static vtkDeviceCamera* New();
+  vtkTypeRevisionMacro(vtkDeviceCamera,vtkOpenGLCamera);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Set the position, focal point and view up, recomputing the view 
+  // transform once
+  void SetPose(const double position[3], const double focalPoint[3], const double viewUp[3]);
+
+  // Description:
+  // Set the pose the head offset is relative to.  If not set, the pose of 
+  // the camera at the first call to SetHeadOffset() is used.
+  void SetReferencePose(const double position[3], const double focalPoint[3], const double viewUp[3]);
+  void ResetReferencePose();
+
+  // Description:
+  // Move the eye by offset from the reference position, keeping the 
+  // reference focal point and view up.  The offset is in the reference 
+  // camera's coordinate system:  x is right, y is up and z is towards the
+  // viewer.
+  void SetHeadOffset(const double offset[3]);
+
+protected:
+  vtkDeviceCamera();
+  ~vtkDeviceCamera();
+
+  int HasReferencePose;
+  double ReferencePosition[3];
+  double ReferenceFocalPoint[3];
+  double ReferenceViewUp[3];
+
+  // Description:
+  // Reference camera axes, cached when the reference pose is set
+  double ReferenceRight[3];
+  double ReferenceUp[3];
+  double ReferenceBackward[3];
+
+private:
+  vtkDeviceCamera(const vtkDeviceCamera&);  // Not implemented.
+  void operator=(const vtkDeviceCamera&);  // Not implemented.
+};
+
+#endif
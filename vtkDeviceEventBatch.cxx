@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Name:        vtkDeviceEventBatch.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkDeviceEventBatch.h"
+
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkObjectFactory.h"
+
+vtkCxxRevisionMacro(vtkDeviceEventBatch, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDeviceEventBatch);
+
+//----------------------------------------------------------------------------
+vtkDeviceEventBatch::vtkDeviceEventBatch() 
+{
+  this->Sensors = vtkIntArray::New();
+  this->Sensors->SetName("Sensors");
+  this->Sensors->SetNumberOfComponents(2);
+
+  this->SensorPositions = vtkDoubleArray::New();
+  this->SensorPositions->SetName("SensorPositions");
+  this->SensorPositions->SetNumberOfComponents(3);
+
+  this->SensorRotations = vtkDoubleArray::New();
+  this->SensorRotations->SetName("SensorRotations");
+  this->SensorRotations->SetNumberOfComponents(4);
+
+  this->ButtonTransitions = vtkIntArray::New();
+  this->ButtonTransitions->SetName("ButtonTransitions");
+  this->ButtonTransitions->SetNumberOfComponents(3);
+
+  this->Channels = vtkIntArray::New();
+  this->Channels->SetName("Channels");
+  this->Channels->SetNumberOfComponents(2);
+
+  this->ChannelValues = vtkDoubleArray::New();
+  this->ChannelValues->SetName("ChannelValues");
+
+  this->Gestures = vtkIntArray::New();
+  this->Gestures->SetName("Gestures");
+  this->Gestures->SetNumberOfComponents(3);
+
+  this->NumberOfEvents = 0;
+  this->FrameNumber = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceEventBatch::~vtkDeviceEventBatch() 
+{
+  this->Sensors->Delete();
+  this->SensorPositions->Delete();
+  this->SensorRotations->Delete();
+  this->ButtonTransitions->Delete();
+  this->Channels->Delete();
+  this->ChannelValues->Delete();
+  this->Gestures->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceEventBatch::Reset() 
+{
+  this->Sensors->Reset();
+  this->SensorPositions->Reset();
+  this->SensorRotations->Reset();
+  this->ButtonTransitions->Reset();
+  this->Channels->Reset();
+  this->ChannelValues->Reset();
+  this->Gestures->Reset();
+
+  this->NumberOfEvents = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceEventBatch::IsEmpty() 
+{
+  return this->Sensors->GetNumberOfTuples() == 0 &&
+         this->ButtonTransitions->GetNumberOfTuples() == 0 &&
+         this->Channels->GetNumberOfTuples() == 0 &&
+         this->Gestures->GetNumberOfTuples() == 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceEventBatch::AddSensor(int device, int sensor, const double position[3], const double rotation[4]) 
+{
+  int ids[2] = { device, sensor };
+  this->Sensors->InsertNextTupleValue(ids);
+  this->SensorPositions->InsertNextTupleValue(position);
+  this->SensorRotations->InsertNextTupleValue(rotation);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceEventBatch::AddButtonTransition(int device, int button, int state) 
+{
+  int transition[3] = { device, button, state };
+  this->ButtonTransitions->InsertNextTupleValue(transition);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceEventBatch::AddChannel(int device, int channel, double value) 
+{
+  int ids[2] = { device, channel };
+  this->Channels->InsertNextTupleValue(ids);
+  this->ChannelValues->InsertNextValue(value);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceEventBatch::AddGesture(int device, int eventId, int numTouchPoints) 
+{
+  int gesture[3] = { device, eventId, numTouchPoints };
+  this->Gestures->InsertNextTupleValue(gesture);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceEventBatch::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "FrameNumber: " << this->FrameNumber << "\n";
+  os << indent << "NumberOfEvents: " << this->NumberOfEvents << "\n";
+  os << indent << "Sensors: " << this->Sensors->GetNumberOfTuples() << "\n";
+  os << indent << "ButtonTransitions: " << this->ButtonTransitions->GetNumberOfTuples() << "\n";
+  os << indent << "Channels: " << this->Channels->GetNumberOfTuples() << "\n";
+  os << indent << "Gestures: " << this->Gestures->GetNumberOfTuples() << "\n";
+}
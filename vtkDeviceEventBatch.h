@@ -0,0 +1,107 @@
+/*=========================================================================
+
+  Name:        vtkDeviceEventBatch.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDeviceEventBatch
+// .SECTION Description
+// vtkDeviceEventBatch holds the device input of one frame, collected by 
+// vtkDeviceBatchStyle, as arrays that can be handled in one go, e.g. 
+// viewed from NumPy via vtk.util.numpy_support.  Devices are identified 
+// by their index in the style.
+//
+// Sensors lists the tracker sensors that moved as (device, sensor) pairs,
+// with their room space positions and rotations (quaternions) in 
+// SensorPositions and SensorRotations.  ButtonTransitions lists buttons 
+// that changed as (device, button, state) triples.  Channels lists 
+// analog channels that changed as (device, channel) pairs, with their 
+// values in ChannelValues.  Gestures lists multi-touch events as 
+// (device, event id, number of touch points) triples, in the order they
+// were received.
+
+// .SECTION see also
+// vtkDeviceBatchStyle
+
+#ifndef __vtkDeviceEventBatch_h
+#define __vtkDeviceEventBatch_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkDoubleArray;
+class vtkIntArray;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceEventBatch : public vtkObject
+{
+public:
+  static vtkDeviceEventBatch* New();
+  vtkTypeRevisionMacro(vtkDeviceEventBatch,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Empty the batch, keeping the memory allocated
+  void Reset();
+
+  // Description:
+  // Whether anything changed this frame
+  int IsEmpty();
+
+  // Description:
+  // Add input to the batch
+  void AddSensor(int device, int sensor, const double position[3], const double rotation[4]);
+  void AddButtonTransition(int device, int button, int state);
+  void AddChannel(int device, int channel, double value);
+  void AddGesture(int device, int eventId, int numTouchPoints);
+
+  // Description:
+  // Get the input of the frame
+  vtkGetObjectMacro(Sensors,vtkIntArray);
+  vtkGetObjectMacro(SensorPositions,vtkDoubleArray);
+  vtkGetObjectMacro(SensorRotations,vtkDoubleArray);
+  vtkGetObjectMacro(ButtonTransitions,vtkIntArray);
+  vtkGetObjectMacro(Channels,vtkIntArray);
+  vtkGetObjectMacro(ChannelValues,vtkDoubleArray);
+  vtkGetObjectMacro(Gestures,vtkIntArray);
+
+  // Description:
+  // Set/get the number of device events collected into the batch
+  vtkSetMacro(NumberOfEvents,int);
+  vtkGetMacro(NumberOfEvents,int);
+
+  // Description:
+  // Set/get the number of the frame
+  vtkSetMacro(FrameNumber,int);
+  vtkGetMacro(FrameNumber,int);
+
+protected:
+  vtkDeviceEventBatch();
+  ~vtkDeviceEventBatch();
+
+  vtkIntArray* Sensors;
+  vtkDoubleArray* SensorPositions;
+  vtkDoubleArray* SensorRotations;
+  vtkIntArray* ButtonTransitions;
+  vtkIntArray* Channels;
+  vtkDoubleArray* ChannelValues;
+  vtkIntArray* Gestures;
+
+  int NumberOfEvents;
+  int FrameNumber;
+
+private:
+  vtkDeviceEventBatch(const vtkDeviceEventBatch&);  // Not implemented.
+  void operator=(const vtkDeviceEventBatch&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Name:        vtkDeviceInertia.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkDeviceInertia.h"
+
+#include "vtkObjectFactory.h"
+
+#include <math.h>
+
+// Weight of the newest sample in the smoothed velocity
+static const double VelocitySmoothing = 0.5;
+
+// Shortest interval for a velocity sample.  Motion from events closer 
+// together, e.g. several in one frame, is accumulated.
+static const double MinimumInterval = 0.001;
+
+vtkCxxRevisionMacro(vtkDeviceInertia, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDeviceInertia);
+
+//----------------------------------------------------------------------------
+vtkDeviceInertia::vtkDeviceInertia() 
+{
+  this->Enabled = 1;
+  this->TimeConstant = 0.3;
+  this->MinimumSpeed = 1.0;
+  this->MaximumReleaseDelay = 0.1;
+
+  this->Stop();
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceInertia::~vtkDeviceInertia() 
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInertia::AddMotion(const double motion[3], double time) 
+{
+  if (this->Coasting) this->Stop();
+
+  for (int i = 0; i < 3; i++)
+    {
+    this->Accumulated[i] += motion[i];
+    }
+
+  // The first event only starts the clock
+  if (this->LastTime < 0.0)
+    {
+    this->LastTime = time;
+    this->Accumulated[0] = this->Accumulated[1] = this->Accumulated[2] = 0.0;
+    return;
+    }
+
+  double dt = time - this->LastTime;
+  if (dt < MinimumInterval) return;
+
+  for (int i = 0; i < 3; i++)
+    {
+    double velocity = this->Accumulated[i] / dt;
+    if (this->NumberOfSamples == 0) this->Velocity[i] = velocity;
+    else this->Velocity[i] += VelocitySmoothing * (velocity - this->Velocity[i]);
+
+    this->Accumulated[i] = 0.0;
+    }
+
+  this->NumberOfSamples++;
+  this->LastTime = time;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInertia::Release(double time) 
+{
+  int moving = this->NumberOfSamples > 0 && 
+               time - this->LastTime <= this->MaximumReleaseDelay &&
+               this->GetSpeed() >= this->MinimumSpeed;
+
+  if (!this->Enabled || !moving)
+    {
+    this->Stop();
+    return;
+    }
+
+  this->Coasting = 1;
+  this->CoastTime = time;
+
+  // The next drag starts a new motion
+  this->NumberOfSamples = 0;
+  this->LastTime = -1.0;
+  this->Accumulated[0] = this->Accumulated[1] = this->Accumulated[2] = 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInertia::Stop() 
+{
+  this->Velocity[0] = this->Velocity[1] = this->Velocity[2] = 0.0;
+  this->NumberOfSamples = 0;
+  this->Accumulated[0] = this->Accumulated[1] = this->Accumulated[2] = 0.0;
+  this->LastTime = -1.0;
+
+  this->Coasting = 0;
+  this->CoastTime = 0.0;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceInertia::Advance(double time, double motion[3]) 
+{
+  motion[0] = motion[1] = motion[2] = 0.0;
+
+  if (!this->Coasting) return 0;
+
+  double dt = time - this->CoastTime;
+  if (dt <= 0.0) return 0;
+  this->CoastTime = time;
+
+  // Integral of v * exp(-t / TimeConstant) over the frame
+  double decay = exp(-dt / this->TimeConstant);
+  double scale = this->TimeConstant * (1.0 - decay);
+  for (int i = 0; i < 3; i++)
+    {
+    motion[i] = this->Velocity[i] * scale;
+    this->Velocity[i] *= decay;
+    }
+
+  if (this->GetSpeed() < this->MinimumSpeed) this->Stop();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+double vtkDeviceInertia::GetSpeed() 
+{
+  return sqrt(this->Velocity[0] * this->Velocity[0] + 
+              this->Velocity[1] * this->Velocity[1] + 
+              this->Velocity[2] * this->Velocity[2]);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInertia::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Enabled: " << this->Enabled << "\n";
+  os << indent << "TimeConstant: " << this->TimeConstant << "\n";
+  os << indent << "MinimumSpeed: " << this->MinimumSpeed << "\n";
+  os << indent << "MaximumReleaseDelay: " << this->MaximumReleaseDelay << "\n";
+  os << indent << "Velocity: (" << this->Velocity[0] << ", " 
+     << this->Velocity[1] << ", " << this->Velocity[2] << ")\n";
+  os << indent << "Coasting: " << this->Coasting << "\n";
+}
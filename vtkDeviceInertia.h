@@ -0,0 +1,126 @@
+/*=========================================================================
+
+  Name:        vtkDeviceInertia.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDeviceInertia
+// .SECTION Description
+// vtkDeviceInertia keeps a motion going after the device driving it lets
+// go, e.g. a camera flicked by a touch drag.  
+//
+// Styles pass each event's motion, of up to three components in the 
+// style's own units, to AddMotion(), which tracks a smoothed velocity.  
+// On Release() the motion coasts if it was moving at release, and each 
+// frame Advance() gives the motion to apply, with the velocity decaying 
+// exponentially with TimeConstant.  The decay is integrated exactly over
+// the time since the last frame, so coasting is frame rate independent.
+// Coasting stops once the speed falls below MinimumSpeed, after which 
+// Advance() returns 0 and nothing needs rendering.
+//
+// .SECTION see also
+// vtkRenciMultiTouchStyleCamera vtkWiiMoteStyleCamera
+
+#ifndef __vtkDeviceInertia_h
+#define __vtkDeviceInertia_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkObject.h"
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceInertia : public vtkObject
+{
+public:
+  static vtkDeviceInertia* New();
+  vtkTypeRevisionMacro(vtkDeviceInertia,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Add the motion of an event at time, in seconds.  Stops any coasting.
+  void AddMotion(const double motion[3], double time);
+
+  // Description:
+  // The device let go at time.  Starts coasting if the motion was still 
+  // moving, i.e. had motion within MaximumReleaseDelay, faster than 
+  // MinimumSpeed.
+  void Release(double time);
+
+  // Description:
+  // Stop coasting and forget the motion
+  void Stop();
+
+  // Description:
+  // Get the motion to apply for the frame at time.  Returns 0, with no 
+  // motion, if not coasting.
+  int Advance(double time, double motion[3]);
+
+  // Description:
+  // Whether the motion is coasting
+  vtkGetMacro(Coasting,int);
+
+  // Description:
+  // Turn coasting on or off.  On by default.
+  vtkSetMacro(Enabled,int);
+  vtkGetMacro(Enabled,int);
+  vtkBooleanMacro(Enabled,int);
+
+  // Description:
+  // Time in seconds for the velocity to decay by a factor of e.  The 
+  // default is 0.3.
+  vtkSetClampMacro(TimeConstant,double,0.001,VTK_DOUBLE_MAX);
+  vtkGetMacro(TimeConstant,double);
+
+  // Description:
+  // Speed, in the style's units per second, below which coasting stops.
+  // The default is 1.
+  vtkSetClampMacro(MinimumSpeed,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MinimumSpeed,double);
+
+  // Description:
+  // Longest time in seconds between the last motion and the release for
+  // the motion to coast.  The default is 0.1.
+  vtkSetClampMacro(MaximumReleaseDelay,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MaximumReleaseDelay,double);
+
+  // Description:
+  // Get the current velocity
+  vtkGetVector3Macro(Velocity,double);
+
+protected:
+  vtkDeviceInertia();
+  ~vtkDeviceInertia();
+
+  int Enabled;
+  double TimeConstant;
+  double MinimumSpeed;
+  double MaximumReleaseDelay;
+
+  double Velocity[3];
+  int NumberOfSamples;
+
+  // Motion since the last velocity sample
+  double Accumulated[3];
+
+  // Time of the last velocity sample, or -1 if there is none
+  double LastTime;
+
+  int Coasting;
+  double CoastTime;
+
+  double GetSpeed();
+
+private:
+  vtkDeviceInertia(const vtkDeviceInertia&);  // Not implemented.
+  void operator=(const vtkDeviceInertia&);  // Not implemented.
+};
+
+#endif
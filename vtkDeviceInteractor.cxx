@@ -16,19 +16,217 @@
 
 #include "vtkDeviceInteractor.h"
 
+#include "vtkCallbackCommand.h"
+#include "vtkCamera.h"
 #include "vtkCommand.h"
+#include "vtkConditionVariable.h"
 #include "vtkDeviceInteractorStyle.h"
 #include "vtkInteractionDevice.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
+#include "vtkProp.h"
+#include "vtkPropCollection.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+#include "vtkTimerLog.h"
 #include "vtkstd/vector"
+#include "vtksys/SystemTools.hxx"
 
 class vtkDeviceInteractorInternals
 {
 public:
+  vtkDeviceInteractorInternals();
+  ~vtkDeviceInteractorInternals();
+
   vtkstd::vector<vtkInteractionDevice*> InteractionDevices;
   vtkstd::vector<vtkDeviceInteractorStyle*> DeviceInteractorStyles;
+
+  // Description:
+  // Pool of worker threads for updating devices in parallel.  Each thread,
+  // including the calling thread, takes the next device from the shared
+  // work list until it is empty, so a slow device doesn't hold up the 
+  // others.
+  void StartWorkers(int num);
+  void StopWorkers();
+  void UpdateDevices();
+
+  vtkMultiThreader* Threader;
+  vtkstd::vector<int> WorkerIds;
+  vtkMutexLock* WorkLock;
+  vtkConditionVariable* WorkReady;
+  vtkConditionVariable* WorkDone;
+
+  // Devices to update this frame
+  vtkstd::vector<vtkInteractionDevice*> Work;
+  unsigned int NextWork;
+  int Generation;
+  int BusyWorkers;
+  int Quit;
+
+  void DoWork();
+  static VTK_THREAD_RETURN_TYPE Worker(void* arg);
 };
 
+//----------------------------------------------------------------------------
+vtkDeviceInteractorInternals::vtkDeviceInteractorInternals()
+{
+  this->Threader = vtkMultiThreader::New();
+  this->WorkLock = vtkMutexLock::New();
+  this->WorkReady = vtkConditionVariable::New();
+  this->WorkDone = vtkConditionVariable::New();
+
+  this->NextWork = 0;
+  this->Generation = 0;
+  this->BusyWorkers = 0;
+  this->Quit = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceInteractorInternals::~vtkDeviceInteractorInternals()
+{
+  this->StopWorkers();
+
+  this->Threader->Delete();
+  this->WorkLock->Delete();
+  this->WorkReady->Delete();
+  this->WorkDone->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorInternals::StartWorkers(int num)
+{
+  this->StopWorkers();
+
+  // Workers wait for the generation to change from 0
+  this->Generation = 0;
+  this->Quit = 0;
+
+  for (int i = 0; i < num; i++)
+    {
+    this->WorkerIds.push_back(this->Threader->SpawnThread(vtkDeviceInteractorInternals::Worker, this));
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorInternals::StopWorkers()
+{
+  if (this->WorkerIds.empty()) return;
+
+  this->WorkLock->Lock();
+  this->Quit = 1;
+  this->WorkReady->Broadcast();
+  this->WorkLock->Unlock();
+
+  for (unsigned int i = 0; i < this->WorkerIds.size(); i++)
+    {
+    this->Threader->TerminateThread(this->WorkerIds[i]);
+    }
+  this->WorkerIds.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorInternals::UpdateDevices()
+{
+  this->WorkLock->Lock();
+  this->NextWork = 0;
+  this->BusyWorkers = (int)this->WorkerIds.size();
+  this->Generation++;
+  this->WorkReady->Broadcast();
+  this->WorkLock->Unlock();
+
+  // Help out
+  this->DoWork();
+
+  this->WorkLock->Lock();
+  while (this->BusyWorkers > 0)
+    {
+    this->WorkDone->Wait(this->WorkLock);
+    }
+  this->WorkLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorInternals::DoWork()
+{
+  while (1)
+    {
+    this->WorkLock->Lock();
+    unsigned int next = this->NextWork++;
+    this->WorkLock->Unlock();
+
+    if (next >= this->Work.size()) return;
+
+    this->Work[next]->Update();
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkDeviceInteractorInternals::Worker(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkDeviceInteractorInternals* self = static_cast<vtkDeviceInteractorInternals*>(info->UserData);
+
+  int generation = 0;
+
+  self->WorkLock->Lock();
+  while (1)
+    {
+    while (self->Generation == generation && !self->Quit)
+      {
+      self->WorkReady->Wait(self->WorkLock);
+      }
+    if (self->Quit) break;
+
+    generation = self->Generation;
+
+    self->WorkLock->Unlock();
+    self->DoWork();
+    self->WorkLock->Lock();
+
+    if (--self->BusyWorkers == 0)
+      {
+      self->WorkDone->Signal();
+      }
+    }
+  self->WorkLock->Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+// The latest modified time of anything rendered in the window:  its 
+// renderers, their cameras and their props
+static unsigned long GetSceneMTime(vtkRenderWindow* window)
+{
+  vtkRendererCollection* renderers = window->GetRenderers();
+  unsigned long time = renderers->GetMTime();
+
+  vtkRenderer* renderer;
+  vtkCollectionSimpleIterator rit;
+  for (renderers->InitTraversal(rit); (renderer = renderers->GetNextRenderer(rit)); )
+    {
+    unsigned long rendererTime = renderer->GetMTime();
+    if (rendererTime > time) time = rendererTime;
+
+    unsigned long cameraTime = renderer->GetActiveCamera()->GetMTime();
+    if (cameraTime > time) time = cameraTime;
+
+    vtkPropCollection* props = renderer->GetViewProps();
+    if (props->GetMTime() > time) time = props->GetMTime();
+
+    vtkProp* prop;
+    vtkCollectionSimpleIterator pit;
+    for (props->InitTraversal(pit); (prop = props->GetNextProp(pit)); )
+      {
+      unsigned long propTime = prop->GetRedrawMTime();
+      if (propTime > time) time = propTime;
+      }
+    }
+
+  return time;
+}
+
 vtkCxxRevisionMacro(vtkDeviceInteractor, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkDeviceInteractor);
 
@@ -36,6 +234,35 @@ vtkStandardNewMacro(vtkDeviceInteractor);
 vtkDeviceInteractor::vtkDeviceInteractor() 
 {
   this->Internals = new vtkDeviceInteractorInternals;
+
+  this->NumberOfUpdateThreads = 1;
+
+  this->MinimumFrameRate = 5.0;
+  this->MaximumFrameRate = 60.0;
+  this->RenderLoad = 0.8;
+  this->FrameRate = this->MaximumFrameRate;
+  this->RenderTime = 0.0;
+
+  this->RenderStartTime = 0.0;
+  this->LastFrameTime = 0.0;
+
+  this->RenderingWindow = NULL;
+  this->SceneTime = 0;
+
+  this->NumberOfRefinementSteps = 0;
+  this->RefinementDelay = 0.25;
+  this->RefinementStep = 0;
+  this->LastActivityTime = 0.0;
+  this->FrameReports = 0;
+
+  this->Refining = 0;
+  this->RefinementAborted = 0;
+  this->LastPollTime = 0.0;
+  this->RefinementWindow = NULL;
+
+  this->AbortCheckCallback = vtkCallbackCommand::New();
+  this->AbortCheckCallback->SetClientData(this);
+  this->AbortCheckCallback->SetCallback(vtkDeviceInteractor::AbortCheck);
 }
 
 //----------------------------------------------------------------------------
@@ -51,19 +278,330 @@ vtkDeviceInteractor::~vtkDeviceInteractor()
     this->Internals->DeviceInteractorStyles[i]->UnRegister(this);
     }
 
+  this->AbortCheckCallback->Delete();
+
   delete this->Internals;
 }
 
+//----------------------------------------------------------------------------
+int vtkDeviceInteractor::InitializeDevices(double timeout)
+{
+  for (unsigned int i = 0; i < this->Internals->InteractionDevices.size(); i++) 
+    {
+    this->Internals->InteractionDevices[i]->InitializeInBackground();
+    }
+
+  double deadline = vtkTimerLog::GetUniversalTime() + timeout;
+
+  while (1)
+    {
+    int initializing = 0;
+    int failed = 0;
+    for (unsigned int i = 0; i < this->Internals->InteractionDevices.size(); i++) 
+      {
+      int state = this->Internals->InteractionDevices[i]->GetConnectionState();
+      if (state == vtkInteractionDevice::Initializing) initializing++;
+      else if (state == vtkInteractionDevice::Disconnected) failed++;
+      }
+
+    if (initializing == 0) 
+      {
+      return failed == 0;
+      }
+
+    if (vtkTimerLog::GetUniversalTime() >= deadline)
+      {
+      vtkWarningMacro(<<initializing << " device(s) still initializing after " << timeout << " seconds.");
+      return 0;
+      }
+
+    vtksys::SystemTools::Delay(1);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkDeviceInteractor::Update()
 {
+  this->ReceiveUpdates();
+  this->InvokeEvents();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::Poll()
+{
+  for (unsigned int i = 0; i < this->Internals->InteractionDevices.size(); i++) 
+    {
+    vtkInteractionDevice* device = this->Internals->InteractionDevices[i];
+
+    if (device->GetConnectionState() == vtkInteractionDevice::Initializing) continue;
+
+    device->Poll();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::ReceiveUpdates()
+{
+  vtkstd::vector<vtkInteractionDevice*>& devices = this->Internals->Work;
+  devices.clear();
+
+  for (unsigned int i = 0; i < this->Internals->InteractionDevices.size(); i++) 
+    {
+    vtkInteractionDevice* device = this->Internals->InteractionDevices[i];
+
+    // Reconnect if necessary, and skip devices still initializing
+    device->UpdateConnectionState();
+    if (device->GetConnectionState() == vtkInteractionDevice::Initializing) continue;
+
+    devices.push_back(device);
+    }
+
+  // Receive updates
+  if (this->Internals->WorkerIds.empty())
+    {
+    for (unsigned int i = 0; i < devices.size(); i++) 
+      {
+      devices[i]->Update();
+      }
+    }
+  else
+    {
+    this->Internals->UpdateDevices();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::InvokeEvents()
+{
+  vtkstd::vector<vtkInteractionDevice*>& devices = this->Internals->Work;
+
+  this->LastFrameTime = vtkTimerLog::GetUniversalTime();
+
+  // Invoke events in a deterministic order on this thread
+  for (unsigned int i = 0; i < devices.size(); i++) 
+    {
+    devices[i]->InvokeInteractionEvent();
+    }
+
+  // Input received so far has now been handled
+  this->FrameReports = this->GetNumberOfReports();
+
+  // Let styles finish the frame
+  int interacting = 0;
+  for (unsigned int i = 0; i < this->Internals->DeviceInteractorStyles.size(); i++) 
+    {
+    this->Internals->DeviceInteractorStyles[i]->EndFrame();
+
+    if (this->Internals->DeviceInteractorStyles[i]->GetInteracting()) interacting = 1;
+    }
+
+  if (interacting)
+    {
+    this->LastActivityTime = vtkTimerLog::GetUniversalTime();
+    this->ResetRefinement();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceInteractor::IsFrameDue()
+{
+  double period = 1.0 / this->FrameRate;
+
+  return vtkTimerLog::GetUniversalTime() - this->LastFrameTime >= period;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceInteractor::IsRenderDue(vtkRenderWindow* window)
+{
+  if (this->NumberOfRefinementSteps == 0 || !this->IsIdle()) return 1;
+
+  // Refinement steps take over once idle, unless the frame changed the 
+  // scene without interacting
+  if (window == NULL || GetSceneMTime(window) == this->SceneTime) return 0;
+
+  this->ResetRefinement();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::StartRender(vtkRenderWindow* window)
+{
+  this->RenderStartTime = vtkTimerLog::GetUniversalTime();
+  this->RenderingWindow = window;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::EndRender()
+{
+  double time = vtkTimerLog::GetUniversalTime() - this->RenderStartTime;
+
+  // Rendering itself modifies the scene, e.g. the cameras' clipping 
+  // ranges, so take its time afterwards
+  if (this->RenderingWindow) 
+    {
+    this->SceneTime = GetSceneMTime(this->RenderingWindow);
+    this->RenderingWindow = NULL;
+    }
+
+  // Smooth out the odd slow render, but follow changes in the scene
+  if (this->RenderTime == 0.0) this->RenderTime = time;
+  else this->RenderTime = 0.5 * (this->RenderTime + time);
+
+  this->UpdateFrameRate();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::UpdateFrameRate()
+{
+  double minimum = this->MinimumFrameRate;
+  double maximum = this->MaximumFrameRate;
+  if (minimum > maximum) minimum = maximum;
+
+  // Leave time for polling between renders
+  double rate = this->RenderTime > 0.0 ? this->RenderLoad / this->RenderTime : maximum;
+
+  if (rate < minimum) rate = minimum;
+  if (rate > maximum) rate = maximum;
+
+  this->FrameRate = rate;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceInteractor::IsIdle()
+{
+  return vtkTimerLog::GetUniversalTime() - this->LastActivityTime >= this->RefinementDelay;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceInteractor::IsRefinementDue()
+{
+  return !this->Refining && 
+         this->RefinementStep < this->NumberOfRefinementSteps && 
+         this->IsIdle() &&
+         this->GetNumberOfReports() == this->FrameReports;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkDeviceInteractor::GetNumberOfReports()
+{
+  unsigned long reports = 0;
   for (unsigned int i = 0; i < this->Internals->InteractionDevices.size(); i++) 
     {
-    this->Internals->InteractionDevices[i]->Update();
-    this->Internals->InteractionDevices[i]->InvokeInteractionEvent();
+    reports += this->Internals->InteractionDevices[i]->GetNumberOfReports();
+    }
+
+  return reports;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::StartRefinement(vtkRenderWindow* window)
+{
+  this->Refining = 1;
+  this->RefinementAborted = 0;
+  this->LastPollTime = vtkTimerLog::GetUniversalTime();
+
+  this->RefinementStep++;
+  this->InvokeEvent(vtkDeviceInteractor::RefineEvent, &this->RefinementStep);
+
+  this->RefinementWindow = window;
+  if (window) window->AddObserver(vtkCommand::AbortCheckEvent, this->AbortCheckCallback);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::EndRefinement()
+{
+  this->Refining = 0;
+
+  if (this->RefinementAborted) this->ResetRefinement();
+
+  if (this->RefinementWindow) 
+    {
+    this->RefinementWindow->RemoveObserver(this->AbortCheckCallback);
+
+    // Observers change the scene for each step, which isn't a reason to
+    // render a frame
+    this->SceneTime = GetSceneMTime(this->RefinementWindow);
+    this->RefinementWindow = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::ResetRefinement()
+{
+  if (this->RefinementStep == 0) return;
+
+  this->RefinementStep = 0;
+  this->InvokeEvent(vtkDeviceInteractor::RefineEvent, &this->RefinementStep);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::AbortCheck(vtkObject*, unsigned long, 
+                                     void* clientdata, void*)
+{
+  vtkDeviceInteractor* self = static_cast<vtkDeviceInteractor*>(clientdata);
+  self->OnAbortCheck();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::OnAbortCheck()
+{
+  if (this->RefinementAborted || this->RefinementWindow == NULL) return;
+
+  // Abort checks can be very frequent, so poll at most once per frame
+  double time = vtkTimerLog::GetUniversalTime();
+  if (time - this->LastPollTime < 1.0 / this->MaximumFrameRate) return;
+  this->LastPollTime = time;
+
+  // Only receive, leaving the events for the frame after the render
+  this->Poll();
+
+  if (this->GetNumberOfReports() != this->FrameReports)
+    {
+    this->RefinementAborted = 1;
+    this->RefinementWindow->SetAbortRender(1);
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkDeviceInteractor::GetNumberOfUpdatedDevices()
+{
+  return static_cast<int>(this->Internals->Work.size());
+}
+
+//----------------------------------------------------------------------------
+vtkInteractionDevice* vtkDeviceInteractor::GetUpdatedDevice(int i)
+{
+  return this->Internals->Work[i];
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::ClearUpdatedDevices()
+{
+  this->Internals->Work.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::AddUpdatedDevice(vtkInteractionDevice* device)
+{
+  this->Internals->Work.push_back(device);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractor::SetNumberOfUpdateThreads(int num)
+{
+  if (num < 1) num = 1;
+  if (num == this->NumberOfUpdateThreads) return;
+
+  this->NumberOfUpdateThreads = num;
+
+  // The calling thread is one of the update threads
+  if (num > 1) this->Internals->StartWorkers(num - 1);
+  else this->Internals->StopWorkers();
+
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 void vtkDeviceInteractor::AddInteractionDevice(vtkInteractionDevice* device)
 {
@@ -96,6 +634,20 @@ void vtkDeviceInteractor::RemoveInteractionDevice(vtkInteractionDevice* device)
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkDeviceInteractor::GetNumberOfInteractionDevices()
+{
+  return static_cast<int>(this->Internals->InteractionDevices.size());
+}
+
+//----------------------------------------------------------------------------
+vtkInteractionDevice* vtkDeviceInteractor::GetInteractionDevice(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfInteractionDevices()) return NULL;
+
+  return this->Internals->InteractionDevices[i];
+}
+
 //----------------------------------------------------------------------------
 void vtkDeviceInteractor::AddDeviceInteractorStyle(vtkDeviceInteractorStyle* device)
 {
@@ -133,6 +685,15 @@ void vtkDeviceInteractor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
+  os << indent << "NumberOfUpdateThreads: " << this->NumberOfUpdateThreads << "\n";
+  os << indent << "MinimumFrameRate: " << this->MinimumFrameRate << "\n";
+  os << indent << "MaximumFrameRate: " << this->MaximumFrameRate << "\n";
+  os << indent << "RenderLoad: " << this->RenderLoad << "\n";
+  os << indent << "FrameRate: " << this->FrameRate << "\n";
+  os << indent << "RenderTime: " << this->RenderTime << "\n";
+  os << indent << "NumberOfRefinementSteps: " << this->NumberOfRefinementSteps << "\n";
+  os << indent << "RefinementDelay: " << this->RefinementDelay << "\n";
+  os << indent << "RefinementStep: " << this->RefinementStep << "\n";
   os << indent << "InteractionDevices:" << endl;
   for (unsigned int i = 0; i < this->Internals->InteractionDevices.size(); i++)
     {
@@ -20,6 +20,29 @@
 // multi-touch interfaces and various devices supported by the Virtual 
 // Reality Peripheral Network (VRPN: 
 // http://www.cs.unc.edu/Research/vrpn/).  
+//
+// The event loop calls Update() once per frame, when IsFrameDue(), then 
+// renders if IsRenderDue(), timing each render with StartRender() and 
+// EndRender().  Between frames it calls Poll(), which receives device 
+// input as it arrives without invoking events, so input never queues up 
+// behind slow renders, each frame applies the newest state, and styles 
+// run once per frame however often devices are polled.  The frame rate 
+// is chosen from the measured render time so that rendering takes 
+// RenderLoad of each frame, leaving the rest for polling, within 
+// MinimumFrameRate and MaximumFrameRate.
+//
+// Once no style has been interacting for RefinementDelay seconds, the 
+// loop only renders frames that changed the scene, e.g. from event 
+// handlers that don't interact, and otherwise renders up to 
+// NumberOfRefinementSteps increasingly expensive refinement steps, one 
+// per IsRefinementDue().  Before each step RefineEvent is invoked with 
+// the step number, starting at 1, so observers can raise quality, e.g. 
+// lower a volume mapper's sample distance or enable extra render passes. 
+// While a step renders, devices are polled from the render window's 
+// AbortCheckEvent, and the render is aborted as soon as any device 
+// reports a change of state.  RefineEvent is then invoked with step 0 so 
+// observers can restore interactive quality.  The input's events are 
+// invoked by the next Update(), once the render has returned.
 
 // .SECTION see also
 // vtkInteractionDeviceManager vtkInteractionDevice 
@@ -31,9 +54,12 @@
 #include "vtkInteractionDeviceConfigure.h"
 
 #include "vtkObject.h"
+#include "vtkCommand.h"
 
+class vtkCallbackCommand;
 class vtkDeviceInteractorStyle;
 class vtkInteractionDevice;
+class vtkRenderWindow;
 
 // Holds vtkstd member variables, which should be hidden
 class vtkDeviceInteractorInternals;
@@ -46,8 +72,30 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description:
-  // Updates devices
-  void Update();
+  // Initialize all devices in parallel on background threads, waiting at 
+  // most timeout seconds for them to finish.  Devices still initializing 
+  // after the timeout carry on in the background and are skipped by 
+  // Update() until they are done.  Returns 1 if all devices initialized 
+  // successfully in time, 0 otherwise.
+  virtual int InitializeDevices(double timeout);
+
+  // Description:
+  // Updates devices and invokes their events.  Called once per frame.
+  virtual void Update();
+
+  // Description:
+  // Receive input from the devices between frames, without invoking 
+  // events.  The next Update() applies it.
+  virtual void Poll();
+
+  // Description:
+  // Number of threads used to receive updates from devices.  With more 
+  // than one, the Update() of each device (the I/O and decoding) runs 
+  // concurrently on a pool of worker threads, while events are still 
+  // invoked on the calling thread in the order the devices were added.
+  // Defaults to 1, which updates all devices on the calling thread.
+  void SetNumberOfUpdateThreads(int num);
+  vtkGetMacro(NumberOfUpdateThreads,int);
 
   // Description:
   // Add/Remove interaction devices
@@ -55,16 +103,159 @@ public:
   void RemoveInteractionDevice(vtkInteractionDevice*);
 
   // Description:
-  // Add/Remove device interactor styles.  This is just used for book-keeping.
+  // Get the interaction devices, in the order they were added
+  int GetNumberOfInteractionDevices();
+  vtkInteractionDevice* GetInteractionDevice(int i);
+
+  // Description:
+  // Add/Remove device interactor styles.  Styles are called at the end of
+  // each Update() via vtkDeviceInteractorStyle::EndFrame().
   void AddDeviceInteractorStyle(vtkDeviceInteractorStyle*);
   void RemoveDeviceInteractorStyle(vtkDeviceInteractorStyle*);
 
+  // Description:
+  // Return 1 if the next frame is due, i.e. 1 / FrameRate seconds after 
+  // the last Update(), so Update() should be called now
+  virtual int IsFrameDue();
+
+  // Description:
+  // Return 1 if the frame just updated should be rendered in the window, 
+  // which it is unless refinement has taken over and the scene hasn't 
+  // changed since it was last rendered.  A changed scene is refined again
+  // from the start.  Call StartRender() and EndRender() around the render
+  // so its time is measured.
+  virtual int IsRenderDue(vtkRenderWindow* window);
+  void StartRender(vtkRenderWindow* window);
+  void EndRender();
+
+  // Description:
+  // Set/get the bounds of the frame rate, in frames per second.  Default 
+  // to 5 and 60.
+  vtkSetClampMacro(MinimumFrameRate,double,0.001,VTK_DOUBLE_MAX);
+  vtkGetMacro(MinimumFrameRate,double);
+  vtkSetClampMacro(MaximumFrameRate,double,0.001,VTK_DOUBLE_MAX);
+  vtkGetMacro(MaximumFrameRate,double);
+
+  // Description:
+  // Set/get the fraction of each frame to spend rendering.  Defaults to 
+  // 0.8.
+  vtkSetClampMacro(RenderLoad,double,0.01,1.0);
+  vtkGetMacro(RenderLoad,double);
+
+  // Description:
+  // Get the frame rate chosen, and the smoothed time of the last renders 
+  // in seconds
+  vtkGetMacro(FrameRate,double);
+  vtkGetMacro(RenderTime,double);
+
+  // Description:
+  // Return 1 if the next refinement step should be rendered now, which 
+  // it isn't while input is waiting for the next frame.  Call 
+  // StartRefinement() and EndRefinement() around rendering it.
+  virtual int IsRefinementDue();
+  void StartRefinement(vtkRenderWindow* window);
+  void EndRefinement();
+
+  // Description:
+  // Set/get the number of refinement steps.  Defaults to 0, which renders 
+  // every frame without refinement.
+  vtkSetClampMacro(NumberOfRefinementSteps,int,0,VTK_INT_MAX);
+  vtkGetMacro(NumberOfRefinementSteps,int);
+
+  // Description:
+  // Set/get the time without interaction, in seconds, before refining.  
+  // Defaults to 0.25.
+  vtkSetClampMacro(RefinementDelay,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(RefinementDelay,double);
+
+  // Description:
+  // Get the last refinement step started, or 0 if not refined
+  vtkGetMacro(RefinementStep,int);
+
+  // Enumeration for events
+  //BTX
+  enum DeviceInteractorEventIds {
+      RefineEvent = vtkCommand::UserEvent + 1
+  };
+  //ETX
+
 protected:
   vtkDeviceInteractor();
   ~vtkDeviceInteractor();
 
   vtkDeviceInteractorInternals* Internals;
 
+  // Description:
+  // The two halves of Update().  ReceiveUpdates() updates the devices that
+  // are ready, recording them as the devices updated this frame.  
+  // InvokeEvents() invokes their events, then ends the frame for styles.
+  void ReceiveUpdates();
+  void InvokeEvents();
+
+  // Description:
+  // Get/set the devices updated this frame
+  int GetNumberOfUpdatedDevices();
+  vtkInteractionDevice* GetUpdatedDevice(int i);
+  void ClearUpdatedDevices();
+  void AddUpdatedDevice(vtkInteractionDevice* device);
+
+  int NumberOfUpdateThreads;
+
+  double MinimumFrameRate;
+  double MaximumFrameRate;
+  double RenderLoad;
+  double FrameRate;
+  double RenderTime;
+
+  double RenderStartTime;
+  double LastFrameTime;
+
+  // The window being rendered, and the modified time of its scene when
+  // last rendered
+  vtkRenderWindow* RenderingWindow;
+  unsigned long SceneTime;
+
+  // Description:
+  // Choose the frame rate from the render time
+  void UpdateFrameRate();
+
+  int NumberOfRefinementSteps;
+  double RefinementDelay;
+  int RefinementStep;
+
+  // Time a style was last interacting
+  double LastActivityTime;
+
+  // Device reports applied by the last frame
+  unsigned long FrameReports;
+
+  // Description:
+  // Get the total number of reports received from the devices
+  unsigned long GetNumberOfReports();
+
+  // State of the step being rendered
+  int Refining;
+  int RefinementAborted;
+  double LastPollTime;
+  vtkRenderWindow* RefinementWindow;
+  vtkCallbackCommand* AbortCheckCallback;
+
+  // Description:
+  // Return 1 if no style has been interacting for RefinementDelay
+  int IsIdle();
+
+  // Description:
+  // Go back to step 0, invoking RefineEvent if refined
+  void ResetRefinement();
+
+  // Description:
+  // Poll devices while a refinement step renders, aborting it on new 
+  // input.  Events aren't invoked, as handlers mustn't change the scene 
+  // mid-render.
+  void OnAbortCheck();
+  static void AbortCheck(vtkObject* caller, unsigned long eid,
+                         void* clientdata, void* calldata);
+
 private:
   vtkDeviceInteractor(const vtkDeviceInteractor&);  // Not implemented.
   void operator=(const vtkDeviceInteractor&);  // Not implemented.
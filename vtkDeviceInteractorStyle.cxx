@@ -17,17 +17,95 @@
 #include "vtkDeviceInteractorStyle.h"
 
 #include "vtkCallbackCommand.h"
+#include "vtkCamera.h"
+#include "vtkCommand.h"
+#include "vtkDeviceCamera.h"
+#include "vtkDevicePicker.h"
+#include "vtkDeviceViewTransform.h"
+#include "vtkInteractionDevice.h"
+#include "vtkMath.h"
+#include "vtkProp.h"
+#include "vtkPropCollection.h"
+#include "vtkRenderWindow.h"
 #include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+#include "vtkTimerLog.h"
+#include "vtkstd/map"
+
+// ComputeVisiblePropBounds() leaves min > max if there is nothing visible
+static inline int BoundsInitialized(const double bounds[6])
+{
+  return bounds[0] <= bounds[1];
+}
+
+// Bounds of a renderer's visible props, and the latest modified time of 
+// the props they were computed from
+struct vtkDeviceInteractorStyleBounds
+{
+  unsigned long Time;
+  double Bounds[6];
+};
+
+class vtkDeviceInteractorStyleBoundsCache
+{
+public:
+  // Renderers aren't referenced, as entries are only used while the 
+  // renderer is the style's or added to it
+  vtkstd::map<vtkRenderer*, vtkDeviceInteractorStyleBounds> Renderers;
+};
+
+// The latest modified time of anything that can change the bounds of a 
+// renderer's props.  Much cheaper than computing the bounds, which asks 
+// every prop for its bounds.
+static unsigned long GetPropsMTime(vtkRenderer* renderer)
+{
+  vtkPropCollection* props = renderer->GetViewProps();
+  unsigned long time = props->GetMTime();
+
+  vtkProp* prop;
+  vtkCollectionSimpleIterator it;
+  for (props->InitTraversal(it); (prop = props->GetNextProp(it)); )
+    {
+    unsigned long propTime = prop->GetRedrawMTime();
+    if (propTime > time) time = propTime;
+    }
+
+  return time;
+}
 
 vtkCxxRevisionMacro(vtkDeviceInteractorStyle, "$Revision: 1.0 $");
 
 vtkCxxSetObjectMacro(vtkDeviceInteractorStyle, Renderer, vtkRenderer);
+vtkCxxSetObjectMacro(vtkDeviceInteractorStyle, Picker, vtkDevicePicker);
 
 //----------------------------------------------------------------------------
 vtkDeviceInteractorStyle::vtkDeviceInteractorStyle() 
 {
   this->Renderer = NULL;
 
+  this->Renderers = vtkRendererCollection::New();
+  this->SharedCamera = 0;
+  this->RenderersUpdateTime = 0;
+  this->BoundsCache = new vtkDeviceInteractorStyleBoundsCache;
+
+  this->Picker = NULL;
+
+  this->ViewTransform = vtkDeviceViewTransform::New();
+
+  this->DesiredUpdateRate = 15.0;
+  this->StillUpdateRate = 0.0001;
+  this->StillDelay = 0.25;
+  this->MinimumInteractionSpeed = 0.0;
+  this->SpeedUpdateRateScale = 0.0;
+
+  this->Interacting = 0;
+  this->LastInteractionTime = 0.0;
+  this->InteractionSpeed = -1.0;
+  this->LastInteractionPosition[0] = 0.0;
+  this->LastInteractionPosition[1] = 0.0;
+  this->LastInteractionPosition[2] = 0.0;
+  this->LastInteractionPositionTime = 0.0;
+
   this->DeviceCallback = vtkCallbackCommand::New();
   this->DeviceCallback->SetClientData(this);
   this->DeviceCallback->SetCallback(vtkDeviceInteractorStyle::ProcessEvents);
@@ -39,6 +117,11 @@ vtkDeviceInteractorStyle::~vtkDeviceInteractorStyle()
   this->DeviceCallback->Delete();
 
   this->SetRenderer(NULL);
+  this->SetPicker(NULL);
+  this->ViewTransform->Delete();
+
+  this->Renderers->Delete();
+  delete this->BoundsCache;
 }
 
 //----------------------------------------------------------------------------
@@ -51,6 +134,242 @@ void vtkDeviceInteractorStyle::ProcessEvents(vtkObject* caller,
   self->OnEvent(caller, eid, calldata);
 }
 
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::OnDeviceEvent(vtkInteractionDevice* device, unsigned long eid) 
+{  
+  this->OnEvent(device, eid, NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::AddRenderer(vtkRenderer* renderer) 
+{  
+  if (renderer == NULL || this->Renderers->IsItemPresent(renderer)) return;
+
+  this->Renderers->AddItem(renderer);
+
+  // Update the new renderer on the next frame
+  this->RenderersUpdateTime = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::RemoveRenderer(vtkRenderer* renderer) 
+{  
+  this->Renderers->RemoveItem(renderer);
+  this->BoundsCache->Renderers.erase(renderer);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::RemoveAllRenderers() 
+{  
+  this->Renderers->RemoveAllItems();
+  this->BoundsCache->Renderers.clear();
+}
+
+//----------------------------------------------------------------------------
+vtkDevicePicker* vtkDeviceInteractorStyle::GetPicker() 
+{  
+  if (this->Picker == NULL)
+    {
+    this->Picker = vtkDevicePicker::New();
+    }
+
+  // Follow the renderer being used
+  this->Picker->SetRenderer(this->Renderer);
+
+  return this->Picker;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceViewTransform* vtkDeviceInteractorStyle::GetViewTransform() 
+{  
+  this->ViewTransform->SetRenderer(this->Renderer);
+
+  return this->ViewTransform;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::EndFrame() 
+{  
+  this->UpdateInteraction();
+
+  this->UpdateRenderers();
+
+  if (this->Picker) this->GetPicker()->UpdateCache();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::Interact(double speed) 
+{  
+  if (speed < this->MinimumInteractionSpeed) return;
+
+  if (speed > this->InteractionSpeed) this->InteractionSpeed = speed;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::InteractAt(const double position[3]) 
+{  
+  double time = vtkTimerLog::GetUniversalTime();
+  double distance = sqrt(vtkMath::Distance2BetweenPoints(position, this->LastInteractionPosition));
+  double dt = time - this->LastInteractionPositionTime;
+
+  int first = this->LastInteractionPositionTime == 0.0;
+
+  for (int i = 0; i < 3; i++) this->LastInteractionPosition[i] = position[i];
+  this->LastInteractionPositionTime = time;
+
+  if (first || distance == 0.0) return;
+
+  this->Interact(dt > 0.0 ? distance / dt : 0.0);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::UpdateInteraction() 
+{  
+  double time = vtkTimerLog::GetUniversalTime();
+  double speed = this->InteractionSpeed;
+  this->InteractionSpeed = -1.0;
+
+  if (speed >= 0.0)
+    {
+    this->LastInteractionTime = time;
+
+    if (!this->Interacting)
+      {
+      this->Interacting = 1;
+      this->InvokeEvent(vtkCommand::StartInteractionEvent, NULL);
+      }
+
+    // Follow the speed while interacting
+    this->SetRenderWindowUpdateRate(this->DesiredUpdateRate * 
+                                    (1.0 + this->SpeedUpdateRateScale * speed));
+    }
+  else if (this->Interacting && time - this->LastInteractionTime >= this->StillDelay)
+    {
+    this->Interacting = 0;
+    this->SetRenderWindowUpdateRate(this->StillUpdateRate);
+    this->InvokeEvent(vtkCommand::EndInteractionEvent, NULL);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::SetRenderWindowUpdateRate(double rate) 
+{  
+  if (this->Renderer && this->Renderer->GetRenderWindow())
+    {
+    this->Renderer->GetRenderWindow()->SetDesiredUpdateRate(rate);
+    }
+
+  // Tiles may be in other windows
+  vtkRenderer* renderer;
+  vtkCollectionSimpleIterator it;
+  for (this->Renderers->InitTraversal(it); (renderer = this->Renderers->GetNextRenderer(it)); )
+    {
+    if (renderer->GetRenderWindow()) renderer->GetRenderWindow()->SetDesiredUpdateRate(rate);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::UpdateRenderers() 
+{  
+  if (this->Renderer == NULL || this->Renderers->GetNumberOfItems() == 0) return;
+
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+
+  // Nothing to do if the camera hasn't moved
+  if (camera->GetMTime() <= this->RenderersUpdateTime) return;
+
+  double bounds[6];
+  this->GetVisiblePropBounds(this->Renderer, bounds);
+
+  vtkRenderer* renderer;
+  vtkCollectionSimpleIterator it;
+
+  if (this->SharedCamera)
+    {
+    // One camera, so its clipping range must cover all renderers
+    for (this->Renderers->InitTraversal(it); (renderer = this->Renderers->GetNextRenderer(it)); )
+      {
+      if (renderer->GetActiveCamera() != camera) renderer->SetActiveCamera(camera);
+
+      double rendererBounds[6];
+      this->GetVisiblePropBounds(renderer, rendererBounds);
+      if (!BoundsInitialized(rendererBounds)) continue;
+
+      if (!BoundsInitialized(bounds))
+        {
+        for (int i = 0; i < 6; i++) bounds[i] = rendererBounds[i];
+        continue;
+        }
+
+      for (int i = 0; i < 3; i++)
+        {
+        if (rendererBounds[i * 2] < bounds[i * 2]) bounds[i * 2] = rendererBounds[i * 2];
+        if (rendererBounds[i * 2 + 1] > bounds[i * 2 + 1]) bounds[i * 2 + 1] = rendererBounds[i * 2 + 1];
+        }
+      }
+
+    this->Renderer->ResetCameraClippingRange(bounds);
+    }
+  else
+    {
+    double* position = camera->GetPosition();
+    double* focalPoint = camera->GetFocalPoint();
+    double* viewUp = camera->GetViewUp();
+
+    for (this->Renderers->InitTraversal(it); (renderer = this->Renderers->GetNextRenderer(it)); )
+      {
+      vtkCamera* rendererCamera = renderer->GetActiveCamera();
+      if (rendererCamera == camera) continue;
+
+      vtkDeviceCamera* deviceCamera = vtkDeviceCamera::SafeDownCast(rendererCamera);
+      if (deviceCamera)
+        {
+        deviceCamera->SetPose(position, focalPoint, viewUp);
+        }
+      else
+        {
+        rendererCamera->SetPosition(position);
+        rendererCamera->SetFocalPoint(focalPoint);
+        rendererCamera->SetViewUp(viewUp);
+        }
+      rendererCamera->SetViewAngle(camera->GetViewAngle());
+      rendererCamera->SetParallelProjection(camera->GetParallelProjection());
+      rendererCamera->SetParallelScale(camera->GetParallelScale());
+
+      // Only recompute the clipping range if the renderer shows something
+      // different
+      double rendererBounds[6];
+      this->GetVisiblePropBounds(renderer, rendererBounds);
+
+      int same = 1;
+      for (int i = 0; i < 6; i++) 
+        {
+        if (rendererBounds[i] != bounds[i]) same = 0;
+        }
+
+      if (same) rendererCamera->SetClippingRange(camera->GetClippingRange());
+      else renderer->ResetCameraClippingRange(rendererBounds);
+      }
+    }
+
+  this->RenderersUpdateTime = camera->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceInteractorStyle::GetVisiblePropBounds(vtkRenderer* renderer, double bounds[6]) 
+{
+  unsigned long time = GetPropsMTime(renderer);
+
+  vtkDeviceInteractorStyleBounds& entry = this->BoundsCache->Renderers[renderer];
+  if (entry.Time != time)
+    {
+    renderer->ComputeVisiblePropBounds(entry.Bounds);
+    entry.Time = time;
+    }
+
+  for (int i = 0; i < 6; i++) bounds[i] = entry.Bounds[i];
+}
+
 //----------------------------------------------------------------------------
 void vtkDeviceInteractorStyle::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -58,6 +377,15 @@ void vtkDeviceInteractorStyle::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Renderer:\n";
   this->Renderer->PrintSelf(os,indent.GetNextIndent());
+  os << indent << "Renderers: " << this->Renderers->GetNumberOfItems() << "\n";
+  os << indent << "SharedCamera: " << this->SharedCamera << "\n";
+  os << indent << "Picker: " << this->Picker << "\n";
+  os << indent << "DesiredUpdateRate: " << this->DesiredUpdateRate << "\n";
+  os << indent << "StillUpdateRate: " << this->StillUpdateRate << "\n";
+  os << indent << "StillDelay: " << this->StillDelay << "\n";
+  os << indent << "MinimumInteractionSpeed: " << this->MinimumInteractionSpeed << "\n";
+  os << indent << "SpeedUpdateRateScale: " << this->SpeedUpdateRateScale << "\n";
+  os << indent << "Interacting: " << this->Interacting << "\n";
   os << indent << "DeviceCallback:\n";
   this->DeviceCallback->PrintSelf(os,indent.GetNextIndent());
 }
\ No newline at end of file
@@ -20,6 +20,14 @@
 // such devices include multi-touch interfaces and various devices 
 // supported by the Virtual Reality Peripheral Network (VRPN: 
 // http://www.cs.unc.edu/Research/vrpn/).  
+//
+// Styles report input activity with Interact().  The first activity 
+// starts an interaction, invoking StartInteractionEvent and switching the
+// render windows to DesiredUpdateRate, so level-of-detail props and 
+// volume mappers can drop quality while moving.  Once there has been no 
+// activity for StillDelay seconds the interaction ends, invoking 
+// EndInteractionEvent and switching back to StillUpdateRate for a full 
+// quality render.
 
 // .SECTION see also
 // vtkDeviceInteractor vtkInteractionDevice
@@ -32,7 +40,14 @@
 #include "vtkObject.h"
 
 class vtkCallbackCommand;
+class vtkDevicePicker;
+class vtkDeviceViewTransform;
+class vtkInteractionDevice;
 class vtkRenderer;
+class vtkRendererCollection;
+
+// Holds vtkstd member variables, which must be hidden
+class vtkDeviceInteractorStyleBoundsCache;
 
 class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceInteractorStyle : public vtkObject
 {
@@ -44,16 +59,151 @@ public:
   // Perform interaction based on an event
   virtual void OnEvent(vtkObject* caller, unsigned long eid, void* callData) = 0;
 
+  // Description:
+  // Perform interaction based on an event from a device this style is 
+  // subscribed to via vtkInteractionDevice::AddDeviceInteractorStyle().
+  // Calls OnEvent() by default.  Subclasses can override this to dispatch 
+  // straight to their handlers.
+  virtual void OnDeviceEvent(vtkInteractionDevice* device, unsigned long eid);
+
   // Description:
   // Set the renderer being used
   void SetRenderer(vtkRenderer*);
 
+  // Description:
+  // Add/remove renderers that follow the camera of the renderer being 
+  // used, e.g. the tiles of a display wall.  Interaction is computed once
+  // for the renderer being used, then its camera's position, focal point,
+  // view up, view angle and parallel projection settings are copied to 
+  // the other renderers' cameras at the end of the frame.  Per-renderer 
+  // settings such as the window center are left alone.
+  void AddRenderer(vtkRenderer*);
+  void RemoveRenderer(vtkRenderer*);
+  void RemoveAllRenderers();
+
+  // Description:
+  // Make all renderers use the camera of the renderer being used, instead 
+  // of copying its state to theirs.  Off by default.
+  vtkSetMacro(SharedCamera,int);
+  vtkGetMacro(SharedCamera,int);
+  vtkBooleanMacro(SharedCamera,int);
+
+  // Description:
+  // Set/get the picker for selecting actors of the renderer being used.
+  // One is created on first use, and can be shared between styles.
+  void SetPicker(vtkDevicePicker*);
+  vtkDevicePicker* GetPicker();
+
+  // Description:
+  // Called by vtkDeviceInteractor once per frame, after events from all 
+  // devices have been invoked.  Updates the added renderers, and starts 
+  // any rebuilds of the picker's cache.
+  virtual void EndFrame();
+
+  // Description:
+  // Set/get the update rates, in frames per second, given to the render 
+  // windows during and after interaction.  The defaults are those of 
+  // vtkRenderWindowInteractor, 15 and 0.0001.
+  vtkSetClampMacro(DesiredUpdateRate,double,0.0001,VTK_DOUBLE_MAX);
+  vtkGetMacro(DesiredUpdateRate,double);
+  vtkSetClampMacro(StillUpdateRate,double,0.0001,VTK_DOUBLE_MAX);
+  vtkGetMacro(StillUpdateRate,double);
+
+  // Description:
+  // Set/get the time without activity, in seconds, before an interaction
+  // ends.  Bridges gaps between device updates so the quality doesn't 
+  // flicker.  Defaults to 0.25.
+  vtkSetClampMacro(StillDelay,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(StillDelay,double);
+
+  // Description:
+  // Set/get the slowest reported speed counted as activity, e.g. to 
+  // ignore tracker jitter.  Defaults to 0, counting all activity.
+  vtkSetClampMacro(MinimumInteractionSpeed,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MinimumInteractionSpeed,double);
+
+  // Description:
+  // Set/get the scaling of DesiredUpdateRate by the reported speed, e.g. 
+  // of the head or hand.  The desired update rate is DesiredUpdateRate * 
+  // (1 + SpeedUpdateRateScale * speed), so faster motion trades more 
+  // quality for frame rate.  Defaults to 0, no scaling.
+  vtkSetClampMacro(SpeedUpdateRateScale,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(SpeedUpdateRateScale,double);
+
+  // Description:
+  // Get whether an interaction is in progress
+  vtkGetMacro(Interacting,int);
+
 protected:
   vtkDeviceInteractorStyle();
   ~vtkDeviceInteractorStyle();
 
   vtkRenderer* Renderer;
+
+  vtkRendererCollection* Renderers;
+  int SharedCamera;
+
+  vtkDevicePicker* Picker;
+
+  vtkDeviceViewTransform* ViewTransform;
+
+  double DesiredUpdateRate;
+  double StillUpdateRate;
+  double StillDelay;
+  double MinimumInteractionSpeed;
+  double SpeedUpdateRateScale;
+
+  int Interacting;
+  double LastInteractionTime;
+
+  // Fastest speed reported this frame, or -1 if no activity
+  double InteractionSpeed;
+
+  // Description:
+  // Report input activity this frame, with the speed of the motion 
+  // causing it in the device's units per second, or 0 if unknown
+  void Interact(double speed = 0.0);
+
+  // Description:
+  // Report the position of a tracked device, e.g. the head, as activity 
+  // with its speed since the last position reported.  Positions that 
+  // haven't moved aren't activity.
+  void InteractAt(const double position[3]);
+
+  double LastInteractionPosition[3];
+  double LastInteractionPositionTime;
+
+  // Description:
+  // Start or end the interaction based on this frame's activity.  Called 
+  // by EndFrame().
+  void UpdateInteraction();
+
+  // Description:
+  // Set the desired update rate of the render windows of all renderers
+  virtual void SetRenderWindowUpdateRate(double rate);
+
+  // Description:
+  // Get the cached world/display transform of the renderer being used, 
+  // for converting points in handlers
+  vtkDeviceViewTransform* GetViewTransform();
+
+  // Description:
+  // Camera modified time at the last update of the added renderers
+  unsigned long RenderersUpdateTime;
+
+  // Description:
+  // Copy the camera of the renderer being used to the added renderers, 
+  // and reset their clipping ranges
+  void UpdateRenderers();
+
+  // Description:
+  // Visible prop bounds of each renderer, only recomputed when its props
+  // change
+  vtkDeviceInteractorStyleBoundsCache* BoundsCache;
+  void GetVisiblePropBounds(vtkRenderer* renderer, double bounds[6]);
   
+  // Description:
+  // For observing devices via AddObserver() instead of subscribing
   vtkCallbackCommand* DeviceCallback;
 
   // Description:
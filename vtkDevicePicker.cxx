@@ -0,0 +1,490 @@
+/*=========================================================================
+
+  Name:        vtkDevicePicker.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkDevicePicker.h"
+
+#include "vtkActor.h"
+#include "vtkActorCollection.h"
+#include "vtkBox.h"
+#include "vtkCellLocator.h"
+#include "vtkDataSet.h"
+#include "vtkDeviceViewTransform.h"
+#include "vtkMapper.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkPropCollection.h"
+#include "vtkRenderer.h"
+#include "vtkstd/vector"
+
+// The cache entry for an actor
+struct vtkDevicePickerEntry
+{
+  vtkActor* Actor;
+
+  // The input the newest locator was built, or is being built, for
+  vtkDataSet* Input;
+  unsigned long InputTime;
+
+  // NULL until the first build finishes
+  vtkCellLocator* Locator;
+
+  // World to data coordinates
+  vtkMatrix4x4* Inverse;
+  unsigned long MatrixTime;
+
+  int Seen;
+};
+
+class vtkDevicePickerInternals
+{
+public:
+  vtkstd::vector<vtkDevicePickerEntry> Entries;
+
+  // Modified time of the renderer's props at the last sync
+  unsigned long PropsTime;
+
+  // The build running on the background thread, if any
+  vtkMultiThreader* Threader;
+  int ThreadId;
+  vtkSimpleMutexLock Lock;
+  vtkActor* BuildActor;
+  vtkDataSet* BuildInput;
+  vtkCellLocator* BuildLocator;
+  int BuildDone;
+
+  static VTK_THREAD_RETURN_TYPE BuildThread(void* arg);
+
+  int FindEntry(vtkActor* actor)
+    {
+    for (unsigned int i = 0; i < this->Entries.size(); i++)
+      {
+      if (this->Entries[i].Actor == actor) return i;
+      }
+    return -1;
+    }
+
+  void RemoveEntry(int i)
+    {
+    vtkDevicePickerEntry& entry = this->Entries[i];
+    entry.Actor->UnRegister(NULL);
+    if (entry.Locator) entry.Locator->Delete();
+    entry.Inverse->Delete();
+
+    this->Entries.erase(this->Entries.begin() + i);
+    }
+};
+
+// The data set a cached actor is picked on, or NULL
+static vtkDataSet* GetPickInput(vtkActor* actor)
+{
+  vtkMapper* mapper = actor->GetMapper();
+
+  return mapper ? mapper->GetInputAsDataSet() : NULL;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkDevicePickerInternals::BuildThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkDevicePickerInternals* self = static_cast<vtkDevicePickerInternals*>(info->UserData);
+
+  // The input is a shallow copy holding the arrays the main thread saw.
+  // Deep copy it here so the locator owns its own data and nothing is 
+  // shared with the main thread once the build is done.
+  vtkDataSet* copy = self->BuildInput->NewInstance();
+  copy->DeepCopy(self->BuildInput);
+  self->BuildLocator->SetDataSet(copy);
+  copy->Delete();
+
+  self->BuildLocator->BuildLocator();
+
+  self->Lock.Lock();
+  self->BuildDone = 1;
+  self->Lock.Unlock();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+vtkCxxRevisionMacro(vtkDevicePicker, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDevicePicker);
+
+vtkCxxSetObjectMacro(vtkDevicePicker, Renderer, vtkRenderer);
+
+//----------------------------------------------------------------------------
+vtkDevicePicker::vtkDevicePicker() 
+{
+  this->Renderer = NULL;
+
+  this->Tolerance = 0.000001;
+  this->NumberOfCellsPerBucket = 25;
+
+  this->Internals = new vtkDevicePickerInternals;
+  this->Internals->PropsTime = 0;
+  this->Internals->Threader = vtkMultiThreader::New();
+  this->Internals->ThreadId = -1;
+  this->Internals->BuildActor = NULL;
+  this->Internals->BuildInput = NULL;
+  this->Internals->BuildLocator = NULL;
+  this->Internals->BuildDone = 0;
+
+  this->ViewTransform = vtkDeviceViewTransform::New();
+
+  this->ClearPick();
+}
+
+//----------------------------------------------------------------------------
+vtkDevicePicker::~vtkDevicePicker() 
+{
+  // Can't free the cache out from under the build thread.  Without the 
+  // renderer no further builds are started.
+  this->SetRenderer(NULL);
+  this->WaitForBuilds();
+
+  while (!this->Internals->Entries.empty())
+    {
+    this->Internals->RemoveEntry(this->Internals->Entries.size() - 1);
+    }
+
+  this->Internals->Threader->Delete();
+  delete this->Internals;
+
+  this->ViewTransform->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkDevicePicker::UpdateCache() 
+{
+  vtkDevicePickerInternals* internals = this->Internals;
+
+  // Swap in a finished locator
+  internals->Lock.Lock();
+  int done = internals->BuildDone;
+  internals->Lock.Unlock();
+
+  if (internals->ThreadId >= 0 && done)
+    {
+    internals->Threader->TerminateThread(internals->ThreadId);
+    internals->ThreadId = -1;
+    internals->BuildDone = 0;
+
+    int i = internals->FindEntry(internals->BuildActor);
+    if (i >= 0)
+      {
+      vtkDevicePickerEntry& entry = internals->Entries[i];
+      if (entry.Locator) entry.Locator->Delete();
+      entry.Locator = internals->BuildLocator;
+      }
+    else
+      {
+      // The actor left the renderer while its locator was being built
+      internals->BuildLocator->Delete();
+      }
+
+    internals->BuildActor->UnRegister(this);
+    internals->BuildActor = NULL;
+    internals->BuildInput->Delete();
+    internals->BuildInput = NULL;
+    internals->BuildLocator = NULL;
+    }
+
+  if (this->Renderer == NULL) return;
+
+  // Add and remove actors, only when the renderer's props have changed
+  vtkPropCollection* props = this->Renderer->GetViewProps();
+  if (props->GetMTime() != internals->PropsTime)
+    {
+    internals->PropsTime = props->GetMTime();
+
+    for (unsigned int i = 0; i < internals->Entries.size(); i++)
+      {
+      internals->Entries[i].Seen = 0;
+      }
+
+    vtkActorCollection* actors = this->Renderer->GetActors();
+    vtkActor* actor;
+    vtkCollectionSimpleIterator it;
+    for (actors->InitTraversal(it); (actor = actors->GetNextActor(it)); )
+      {
+      int i = internals->FindEntry(actor);
+      if (i < 0)
+        {
+        vtkDevicePickerEntry entry;
+        entry.Actor = actor;
+        entry.Actor->Register(NULL);
+        entry.Input = NULL;
+        entry.InputTime = 0;
+        entry.Locator = NULL;
+        entry.Inverse = vtkMatrix4x4::New();
+        entry.MatrixTime = 0;
+
+        internals->Entries.push_back(entry);
+        i = internals->Entries.size() - 1;
+        }
+
+      internals->Entries[i].Seen = 1;
+      }
+
+    for (int i = static_cast<int>(internals->Entries.size()) - 1; i >= 0; i--)
+      {
+      if (!internals->Entries[i].Seen) internals->RemoveEntry(i);
+      }
+    }
+
+  // Start building the first out of date locator
+  if (internals->ThreadId >= 0) return;
+
+  for (unsigned int i = 0; i < internals->Entries.size(); i++)
+    {
+    vtkDevicePickerEntry& entry = internals->Entries[i];
+
+    vtkDataSet* input = GetPickInput(entry.Actor);
+    if (input == NULL || (input == entry.Input && input->GetMTime() == entry.InputTime))
+      {
+      continue;
+      }
+
+    entry.Input = input;
+    entry.InputTime = input->GetMTime();
+
+    // Only reference the input's arrays here; the build thread does the 
+    // deep copy.  Pipeline updates replace arrays rather than edit them, 
+    // so the shallow copy stays as it is now.
+    internals->BuildInput = input->NewInstance();
+    internals->BuildInput->ShallowCopy(input);
+
+    internals->BuildLocator = vtkCellLocator::New();
+    internals->BuildLocator->SetNumberOfCellsPerBucket(this->NumberOfCellsPerBucket);
+    internals->BuildLocator->CacheCellBoundsOn();
+
+    internals->BuildActor = entry.Actor;
+    internals->BuildActor->Register(this);
+    internals->BuildDone = 0;
+    internals->ThreadId = internals->Threader->SpawnThread(vtkDevicePickerInternals::BuildThread, internals);
+
+    break;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDevicePicker::WaitForBuilds() 
+{
+  while (this->Internals->ThreadId >= 0)
+    {
+    // Wait for the thread to finish, then let UpdateCache() take its 
+    // locator and start the next build
+    this->Internals->Threader->TerminateThread(this->Internals->ThreadId);
+
+    this->Internals->Lock.Lock();
+    this->Internals->BuildDone = 1;
+    this->Internals->Lock.Unlock();
+
+    this->UpdateCache();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkDevicePicker::PickSegment(const double p1[3], const double p2[3]) 
+{
+  this->ClearPick();
+  this->UpdateCache();
+
+  vtkDevicePickerInternals* internals = this->Internals;
+
+  double origin[3] = { p1[0], p1[1], p1[2] };
+  double direction[3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+
+  // Parametric coordinate of the nearest hit along the segment
+  double nearest = VTK_DOUBLE_MAX;
+
+  for (unsigned int i = 0; i < internals->Entries.size(); i++)
+    {
+    vtkDevicePickerEntry& entry = internals->Entries[i];
+    vtkActor* actor = entry.Actor;
+
+    if (entry.Locator == NULL || !actor->GetVisibility() || !actor->GetPickable()) continue;
+
+    // Skip actors the segment misses, or that are behind the nearest hit
+    double* bounds = actor->GetBounds();
+    double coord[3], t;
+    if (bounds == NULL || 
+        !vtkBox::IntersectBox(bounds, origin, direction, coord, t) || 
+        t > 1.0 || t > nearest) 
+      {
+      continue;
+      }
+
+    // Pick in data coordinates.  The transform is affine, so parametric 
+    // coordinates along the segment are the same in both.
+    vtkMatrix4x4* matrix = actor->GetMatrix();
+    if (matrix->GetMTime() != entry.MatrixTime)
+      {
+      vtkMatrix4x4::Invert(matrix, entry.Inverse);
+      entry.MatrixTime = matrix->GetMTime();
+      }
+
+    double a[4] = { p1[0], p1[1], p1[2], 1.0 };
+    double b[4] = { p2[0], p2[1], p2[2], 1.0 };
+    entry.Inverse->MultiplyPoint(a, a);
+    entry.Inverse->MultiplyPoint(b, b);
+    for (int j = 0; j < 3; j++)
+      {
+      a[j] /= a[3];
+      b[j] /= b[3];
+      }
+
+    double x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    if (entry.Locator->IntersectWithLine(a, b, this->Tolerance, t, x, pcoords, subId, cellId) &&
+        t < nearest)
+      {
+      nearest = t;
+      this->Actor = actor;
+      this->CellId = cellId;
+      }
+    }
+
+  if (this->Actor == NULL) return 0;
+
+  for (int i = 0; i < 3; i++)
+    {
+    this->PickPosition[i] = p1[i] + nearest * direction[i];
+    }
+  this->Distance = nearest * vtkMath::Norm(direction);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkDevicePicker::PickRay(const double origin[3], const double direction[3]) 
+{
+  this->UpdateCache();
+
+  double length = vtkMath::Norm(direction);
+  if (length == 0.0) 
+    {
+    this->ClearPick();
+    return 0;
+    }
+
+  // Every point of the cached actors' bounds is within the distance to 
+  // their center plus half their diagonal
+  double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, 
+                      -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (unsigned int i = 0; i < this->Internals->Entries.size(); i++)
+    {
+    double* actorBounds = this->Internals->Entries[i].Actor->GetBounds();
+    if (actorBounds == NULL) continue;
+
+    for (int j = 0; j < 3; j++)
+      {
+      if (actorBounds[2 * j] < bounds[2 * j]) bounds[2 * j] = actorBounds[2 * j];
+      if (actorBounds[2 * j + 1] > bounds[2 * j + 1]) bounds[2 * j + 1] = actorBounds[2 * j + 1];
+      }
+    }
+
+  if (bounds[0] > bounds[1])
+    {
+    this->ClearPick();
+    return 0;
+    }
+
+  double center[3], halfDiagonal[3];
+  for (int i = 0; i < 3; i++)
+    {
+    center[i] = (bounds[2 * i] + bounds[2 * i + 1]) * 0.5;
+    halfDiagonal[i] = (bounds[2 * i + 1] - bounds[2 * i]) * 0.5;
+    }
+  double reach = sqrt(vtkMath::Distance2BetweenPoints(origin, center)) + vtkMath::Norm(halfDiagonal);
+
+  double end[3];
+  for (int i = 0; i < 3; i++)
+    {
+    end[i] = origin[i] + direction[i] / length * reach;
+    }
+
+  return this->PickSegment(origin, end);
+}
+
+//----------------------------------------------------------------------------
+int vtkDevicePicker::PickDisplay(double x, double y) 
+{
+  if (this->Renderer == NULL) 
+    {
+    this->ClearPick();
+    return 0;
+    }
+
+  // Unproject onto the near and far clipping planes
+  double display[6] = { x, y, 0.0, x, y, 1.0 };
+  double world[6];
+  this->ViewTransform->SetRenderer(this->Renderer);
+  this->ViewTransform->DisplayToWorld(display, world, 2);
+
+  return this->PickSegment(world, world + 3);
+}
+
+//----------------------------------------------------------------------------
+void vtkDevicePicker::ClearPick() 
+{
+  this->Actor = NULL;
+  this->PickPosition[0] = this->PickPosition[1] = this->PickPosition[2] = 0.0;
+  this->CellId = -1;
+  this->Distance = 0.0;
+}
+
+//----------------------------------------------------------------------------
+int vtkDevicePicker::GetNumberOfCachedActors() 
+{
+  return this->Internals->Entries.size();
+}
+
+//----------------------------------------------------------------------------
+int vtkDevicePicker::GetNumberOfPendingBuilds() 
+{
+  int pending = 0;
+  for (unsigned int i = 0; i < this->Internals->Entries.size(); i++)
+    {
+    vtkDevicePickerEntry& entry = this->Internals->Entries[i];
+    vtkDataSet* input = GetPickInput(entry.Actor);
+
+    if (entry.Actor == this->Internals->BuildActor ||
+        (input && (input != entry.Input || input->GetMTime() != entry.InputTime)))
+      {
+      pending++;
+      }
+    }
+
+  return pending;
+}
+
+//----------------------------------------------------------------------------
+void vtkDevicePicker::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "NumberOfCellsPerBucket: " << this->NumberOfCellsPerBucket << "\n";
+  os << indent << "NumberOfCachedActors: " << this->Internals->Entries.size() << "\n";
+  os << indent << "Actor: " << this->Actor << "\n";
+  os << indent << "PickPosition: (" << this->PickPosition[0] << ", " 
+     << this->PickPosition[1] << ", " << this->PickPosition[2] << ")\n";
+  os << indent << "CellId: " << this->CellId << "\n";
+  os << indent << "Distance: " << this->Distance << "\n";
+}
@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Name:        vtkDevicePicker.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDevicePicker
+// .SECTION Description
+// vtkDevicePicker picks actors along rays fast enough to run on every 
+// device report, e.g. for a wand ray from a vtkVRPNTracker or a touch on
+// a vtkRenciMultiTouch.  
+//
+// A vtkCellLocator is cached for each actor of the renderer.  Picks only
+// visit actors whose bounds the ray crosses, and only the cells near the
+// ray within those, instead of every cell of every prop as VTK's generic 
+// pickers do.  The cache follows the renderer:  actors are added and 
+// removed as they come and go, and locators are rebuilt when an actor's
+// input changes.  Locators are built on a background thread, which also
+// copies the input, and the old locator is picked until the new one is 
+// ready, so edits never stall interaction.  Actors are pickable once 
+// their first locator is built.
+//
+// Only actors with vtkDataSet inputs are picked.  The pipeline isn't 
+// updated, so picks see the data last rendered.  The picker must be used
+// from a single thread.
+
+// .SECTION see also
+// vtkDeviceInteractorStyle vtkCellLocator
+
+#ifndef __vtkDevicePicker_h
+#define __vtkDevicePicker_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkActor;
+class vtkDeviceViewTransform;
+class vtkRenderer;
+
+// Holds the locator cache and build thread, which are hidden
+class vtkDevicePickerInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDevicePicker : public vtkObject
+{
+public:
+  static vtkDevicePicker* New();
+  vtkTypeRevisionMacro(vtkDevicePicker,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Set/get the renderer whose actors are picked
+  void SetRenderer(vtkRenderer*);
+  vtkGetObjectMacro(Renderer,vtkRenderer);
+
+  // Description:
+  // Pick the actor nearest p1 along the segment from p1 to p2, in world 
+  // coordinates.  Returns 1 if an actor was hit.
+  int PickSegment(const double p1[3], const double p2[3]);
+
+  // Description:
+  // Pick along a ray from origin in direction, e.g. a wand.  The ray is 
+  // long enough to cross every cached actor.
+  int PickRay(const double origin[3], const double direction[3]);
+
+  // Description:
+  // Pick through a display point, from the near to the far clipping 
+  // plane, e.g. under a touch.  Touch locations normalized to [0, 1] are 
+  // scaled by the render window size to display coordinates.
+  int PickDisplay(double x, double y);
+
+  // Description:
+  // Get the result of the last pick:  the actor hit, or NULL, the world 
+  // position and cell id of the hit, and the distance from the start of 
+  // the segment or ray
+  vtkGetObjectMacro(Actor,vtkActor);
+  vtkGetVector3Macro(PickPosition,double);
+  vtkGetMacro(CellId,vtkIdType);
+  vtkGetMacro(Distance,double);
+
+  // Description:
+  // Tolerance for hitting cells, as passed to vtkCellLocator
+  vtkSetClampMacro(Tolerance,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(Tolerance,double);
+
+  // Description:
+  // Number of cells per locator bucket.  Applies to locators built after 
+  // it is set.
+  vtkSetClampMacro(NumberOfCellsPerBucket,int,1,VTK_INT_MAX);
+  vtkGetMacro(NumberOfCellsPerBucket,int);
+
+  // Description:
+  // Bring the cache up to date with the renderer, starting any builds 
+  // needed.  Called by each pick, and can be called once per frame so 
+  // rebuilds start before the next pick.
+  void UpdateCache();
+
+  // Description:
+  // Wait for all pending locator builds to finish
+  void WaitForBuilds();
+
+  // Description:
+  // Get the number of actors cached, and of those waiting for a locator
+  int GetNumberOfCachedActors();
+  int GetNumberOfPendingBuilds();
+
+protected:
+  vtkDevicePicker();
+  ~vtkDevicePicker();
+
+  vtkRenderer* Renderer;
+
+  vtkActor* Actor;
+  double PickPosition[3];
+  vtkIdType CellId;
+  double Distance;
+
+  double Tolerance;
+  int NumberOfCellsPerBucket;
+
+  vtkDevicePickerInternals* Internals;
+
+  vtkDeviceViewTransform* ViewTransform;
+
+  // Description:
+  // Clear the pick result
+  void ClearPick();
+
+private:
+  vtkDevicePicker(const vtkDevicePicker&);  // Not implemented.
+  void operator=(const vtkDevicePicker&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,377 @@
+/*=========================================================================
+
+  Name:        vtkDeviceStateCodec.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkDeviceStateCodec.h"
+
+#include "vtkDeviceInteractor.h"
+#include "vtkDeviceStateStream.h"
+#include "vtkInteractionDevice.h"
+#include "vtkObjectFactory.h"
+#include "vtkstd/vector"
+
+#include <string.h>
+
+// Snapshot header.  Values are in host byte order, so a decoder with the
+// other byte order sees a byte-swapped magic number.
+#define VTK_SNAPSHOT_MAGIC 0x56545353
+#define VTK_SNAPSHOT_VERSION 4
+
+// How each device's state is encoded
+#define VTK_SNAPSHOT_UNCHANGED 0
+#define VTK_SNAPSHOT_FULL 1
+#define VTK_SNAPSHOT_DELTA 2
+
+class vtkDeviceStateCodecInternals
+{
+public:
+  vtkDeviceStateCodecInternals()
+    {
+    this->HasHistory = 0;
+    this->PositionPrecision = 0.0;
+    this->RotationPrecision = 0.0;
+    }
+
+  // State of each device in the previous snapshot, as written by 
+  // vtkInteractionDevice::WriteState()
+  vtkstd::vector<vtkstd::vector<unsigned char> > Previous;
+  int HasHistory;
+
+  // Precisions of the previous snapshot
+  double PositionPrecision;
+  double RotationPrecision;
+
+  // Encoded delta
+  vtkstd::vector<unsigned char> Delta;
+};
+
+// Unsigned LEB128 variable length integers
+static void AppendVarInt(vtkstd::vector<unsigned char>& buffer, unsigned int value)
+{
+  while (value >= 0x80)
+    {
+    buffer.push_back(static_cast<unsigned char>(value | 0x80));
+    value >>= 7;
+    }
+  buffer.push_back(static_cast<unsigned char>(value));
+}
+
+static int ParseVarInt(const unsigned char*& data, const unsigned char* end, unsigned int& value)
+{
+  value = 0;
+  for (int shift = 0; shift < 32 && data < end; shift += 7)
+    {
+    unsigned char byte = *data++;
+    value |= static_cast<unsigned int>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return 1;
+    }
+  return 0;
+}
+
+// Encode the XOR of the current and previous state as alternating runs 
+// of unchanged bytes and changed bytes.  Quantized values that change 
+// slowly differ only in their low bytes, so most of the XOR is zero.
+static void EncodeDelta(const unsigned char* current, const unsigned char* previous, int size,
+                        vtkstd::vector<unsigned char>& delta)
+{
+  delta.clear();
+
+  int i = 0;
+  while (i < size)
+    {
+    int start = i;
+    while (i < size && current[i] == previous[i]) i++;
+    AppendVarInt(delta, i - start);
+
+    // A single unchanged byte is cheaper to send than to start a new run
+    start = i;
+    while (i < size && (current[i] != previous[i] || 
+                        (i + 1 < size && current[i + 1] != previous[i + 1])))
+      {
+      i++;
+      }
+    AppendVarInt(delta, i - start);
+
+    for (int j = start; j < i; j++)
+      {
+      delta.push_back(current[j] ^ previous[j]);
+      }
+    }
+}
+
+// Apply a delta to the previous state in place
+static int DecodeDelta(const unsigned char* delta, int deltaSize, unsigned char* state, int size)
+{
+  const unsigned char* end = delta + deltaSize;
+
+  int i = 0;
+  while (delta < end)
+    {
+    unsigned int unchanged, changed;
+    if (!ParseVarInt(delta, end, unchanged) || !ParseVarInt(delta, end, changed)) return 0;
+    if (unchanged > static_cast<unsigned int>(size - i)) return 0;
+    i += unchanged;
+
+    if (changed > static_cast<unsigned int>(size - i) || 
+        changed > static_cast<unsigned int>(end - delta)) return 0;
+    for (unsigned int j = 0; j < changed; j++)
+      {
+      state[i++] ^= *delta++;
+      }
+    }
+
+  return 1;
+}
+
+vtkCxxRevisionMacro(vtkDeviceStateCodec, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDeviceStateCodec);
+
+//----------------------------------------------------------------------------
+vtkDeviceStateCodec::vtkDeviceStateCodec() 
+{
+  // Ten microns, if positions are in meters
+  this->PositionPrecision = 0.00001;
+  this->RotationPrecision = 0.000001;
+  this->KeyframeInterval = 1000;
+
+  this->SequenceNumber = -1;
+  this->Keyframe = 0;
+
+  this->DeviceStream = vtkDeviceStateStream::New();
+
+  this->Internals = new vtkDeviceStateCodecInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceStateCodec::~vtkDeviceStateCodec() 
+{
+  this->DeviceStream->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceStateCodec::GetFormatVersion() 
+{
+  return VTK_SNAPSHOT_VERSION;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateCodec::ResetHistory() 
+{
+  this->Internals->Previous.clear();
+  this->Internals->HasHistory = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceStateCodec::Encode(vtkDeviceInteractor* interactor, vtkDeviceStateStream* output) 
+{
+  if (interactor == NULL || output == NULL) return 0;
+
+  vtkDeviceStateCodecInternals* internals = this->Internals;
+  int numDevices = interactor->GetNumberOfInteractionDevices();
+  int sequence = this->SequenceNumber + 1;
+
+  // Deltas need a previous snapshot of the same devices and precisions
+  this->Keyframe = !internals->HasHistory ||
+                   static_cast<int>(internals->Previous.size()) != numDevices ||
+                   internals->PositionPrecision != this->PositionPrecision ||
+                   internals->RotationPrecision != this->RotationPrecision ||
+                   (this->KeyframeInterval > 0 && sequence % this->KeyframeInterval == 0);
+
+  output->WriteInt(VTK_SNAPSHOT_MAGIC);
+  output->WriteInt(VTK_SNAPSHOT_VERSION);
+  output->WriteInt(sequence);
+  output->WriteInt(this->Keyframe ? -1 : this->SequenceNumber);
+  output->WriteDouble(this->PositionPrecision);
+  output->WriteDouble(this->RotationPrecision);
+  output->WriteInt(numDevices);
+
+  internals->Previous.resize(numDevices);
+
+  this->DeviceStream->SetPositionPrecision(this->PositionPrecision);
+  this->DeviceStream->SetRotationPrecision(this->RotationPrecision);
+
+  for (int i = 0; i < numDevices; i++)
+    {
+    vtkstd::vector<unsigned char>& previous = internals->Previous[i];
+
+    this->DeviceStream->Reset();
+    interactor->GetInteractionDevice(i)->WriteState(this->DeviceStream);
+
+    const unsigned char* state = this->DeviceStream->GetData();
+    int size = this->DeviceStream->GetSize();
+
+    unsigned char encoding = VTK_SNAPSHOT_FULL;
+    if (!this->Keyframe && size == static_cast<int>(previous.size()))
+      {
+      if (size == 0 || memcmp(state, &previous[0], size) == 0)
+        {
+        encoding = VTK_SNAPSHOT_UNCHANGED;
+        }
+      else
+        {
+        EncodeDelta(state, &previous[0], size, internals->Delta);
+        if (internals->Delta.size() < static_cast<unsigned int>(size)) encoding = VTK_SNAPSHOT_DELTA;
+        }
+      }
+
+    output->WriteBytes(&encoding, 1);
+
+    if (encoding == VTK_SNAPSHOT_FULL)
+      {
+      output->WriteInt(size);
+      output->WriteBytes(state, size);
+      }
+    else if (encoding == VTK_SNAPSHOT_DELTA)
+      {
+      output->WriteInt(static_cast<int>(internals->Delta.size()));
+      output->WriteBytes(&internals->Delta[0], static_cast<int>(internals->Delta.size()));
+      }
+
+    if (encoding != VTK_SNAPSHOT_UNCHANGED)
+      {
+      previous.assign(state, state + size);
+      }
+    }
+
+  internals->HasHistory = 1;
+  internals->PositionPrecision = this->PositionPrecision;
+  internals->RotationPrecision = this->RotationPrecision;
+
+  this->SequenceNumber = sequence;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceStateCodec::Decode(vtkDeviceStateStream* input, vtkDeviceInteractor* interactor) 
+{
+  if (input == NULL || interactor == NULL) return 0;
+
+  vtkDeviceStateCodecInternals* internals = this->Internals;
+
+  if (input->ReadInt() != VTK_SNAPSHOT_MAGIC)
+    {
+    vtkErrorMacro(<<"Not a device state snapshot, or written with a different byte order.");
+    return 0;
+    }
+
+  int version = input->ReadInt();
+  if (version != VTK_SNAPSHOT_VERSION)
+    {
+    vtkErrorMacro(<<"Can't decode snapshot version " << version << ".");
+    return 0;
+    }
+
+  int sequence = input->ReadInt();
+  int base = input->ReadInt();
+  double positionPrecision = input->ReadDouble();
+  double rotationPrecision = input->ReadDouble();
+  int numDevices = input->ReadInt();
+
+  if (input->GetError()) 
+    {
+    vtkErrorMacro(<<"Truncated snapshot header.");
+    return 0;
+    }
+
+  if (numDevices != interactor->GetNumberOfInteractionDevices())
+    {
+    vtkErrorMacro(<<"Snapshot has " << numDevices << " devices, but " 
+                  << interactor->GetNumberOfInteractionDevices() << " were added.");
+    return 0;
+    }
+
+  // Deltas can only be applied to the snapshot they were encoded against
+  int keyframe = base < 0;
+  if (!keyframe && (!internals->HasHistory || base != this->SequenceNumber))
+    {
+    vtkWarningMacro(<<"Skipping snapshot " << sequence << ", which needs snapshot " << base << ".");
+    return 0;
+    }
+
+  internals->Previous.resize(numDevices);
+
+  this->DeviceStream->SetPositionPrecision(positionPrecision);
+  this->DeviceStream->SetRotationPrecision(rotationPrecision);
+
+  int corrupt = 0;
+  for (int i = 0; i < numDevices && !corrupt; i++)
+    {
+    vtkstd::vector<unsigned char>& previous = internals->Previous[i];
+
+    unsigned char encoding;
+    input->ReadBytes(&encoding, 1);
+    if (encoding == VTK_SNAPSHOT_UNCHANGED) continue;
+
+    int size = input->ReadInt();
+    int position = input->GetPosition();
+    if (input->GetError() || size < 0 || position + size > input->GetSize()) 
+      {
+      corrupt = 1;
+      break;
+      }
+
+    if (encoding == VTK_SNAPSHOT_FULL)
+      {
+      // Read straight from the snapshot
+      const unsigned char* state = input->GetData() + position;
+      this->DeviceStream->SetExternalData(state, size);
+      previous.assign(state, state + size);
+      }
+    else if (encoding == VTK_SNAPSHOT_DELTA && !keyframe && !previous.empty() &&
+             DecodeDelta(input->GetData() + position, size, &previous[0], static_cast<int>(previous.size())))
+      {
+      // The previous state has been patched in place, so read from that
+      this->DeviceStream->SetExternalData(&previous[0], static_cast<int>(previous.size()));
+      }
+    else
+      {
+      corrupt = 1;
+      break;
+      }
+
+    interactor->GetInteractionDevice(i)->ReadState(this->DeviceStream);
+    corrupt = this->DeviceStream->GetError();
+
+    input->SetPosition(position + size);
+    }
+
+  if (corrupt)
+    {
+    // Wait for a keyframe, as some devices may be out of step
+    vtkErrorMacro(<<"Corrupt snapshot " << sequence << ".");
+    this->ResetHistory();
+    return 0;
+    }
+
+  internals->HasHistory = 1;
+  this->SequenceNumber = sequence;
+  this->Keyframe = keyframe;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateCodec::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "PositionPrecision: " << this->PositionPrecision << "\n";
+  os << indent << "RotationPrecision: " << this->RotationPrecision << "\n";
+  os << indent << "KeyframeInterval: " << this->KeyframeInterval << "\n";
+  os << indent << "SequenceNumber: " << this->SequenceNumber << "\n";
+  os << indent << "Keyframe: " << this->Keyframe << "\n";
+}
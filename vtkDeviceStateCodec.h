@@ -0,0 +1,125 @@
+/*=========================================================================
+
+  Name:        vtkDeviceStateCodec.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDeviceStateCodec
+// .SECTION Description
+// vtkDeviceStateCodec encodes a snapshot of the state of all devices in 
+// a vtkDeviceInteractor (tracker sensors, buttons, analog channels, the 
+// current gesture and its touch points, etc.) in a compact, versioned 
+// binary format, e.g. for sending input to another process or recording 
+// it to disk.
+//
+// Positions and rotations are quantized to configurable precisions, and
+// buttons are packed one bit each.  Each snapshot is delta-encoded 
+// against the previous one:  devices whose state hasn't changed take one
+// byte, and changed devices send only the bytes that differ.  A keyframe
+// with the full state is sent every KeyframeInterval snapshots, so a 
+// decoder that has missed snapshots can resynchronize.
+//
+// Decoding reads each device's state directly from the snapshot, or from
+// the reconstructed previous state, into the device's own storage via 
+// vtkInteractionDevice::ReadState().  Devices must be added to the 
+// decoding interactor in the same order as the encoding one.  Use 
+// separate codecs for encoding and decoding, as each keeps the history 
+// for its direction.
+
+// .SECTION see also
+// vtkDeviceStateStream vtkDeviceInteractor vtkClusterDeviceInteractor
+
+#ifndef __vtkDeviceStateCodec_h
+#define __vtkDeviceStateCodec_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkDeviceInteractor;
+class vtkDeviceStateStream;
+
+// Holds vtkstd member variables, which must be hidden
+class vtkDeviceStateCodecInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceStateCodec : public vtkObject
+{
+public:
+  static vtkDeviceStateCodec* New();
+  vtkTypeRevisionMacro(vtkDeviceStateCodec,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Append a snapshot of the state of all devices to the stream.  Returns
+  // 1 on success, 0 otherwise.
+  int Encode(vtkDeviceInteractor* interactor, vtkDeviceStateStream* output);
+
+  // Description:
+  // Decode the snapshot at the read position of the stream into the 
+  // devices.  Returns 0 if the snapshot is invalid, or is a delta against
+  // a snapshot this codec hasn't decoded, in which case the devices are
+  // left unchanged until the next keyframe.
+  int Decode(vtkDeviceStateStream* input, vtkDeviceInteractor* interactor);
+
+  // Description:
+  // Forget the previous snapshot, so the next one encoded is a keyframe
+  void ResetHistory();
+
+  // Description:
+  // Set/get the precision positions and rotations are quantized to when 
+  // encoding.  0 stores them exactly.  Decoding uses the precisions 
+  // stored in the snapshot.
+  vtkSetClampMacro(PositionPrecision,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(PositionPrecision,double);
+  vtkSetClampMacro(RotationPrecision,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(RotationPrecision,double);
+
+  // Description:
+  // Set/get the number of snapshots between keyframes.  0 only sends a 
+  // keyframe first, and after ResetHistory().
+  vtkSetClampMacro(KeyframeInterval,int,0,VTK_INT_MAX);
+  vtkGetMacro(KeyframeInterval,int);
+
+  // Description:
+  // Get the sequence number of the last snapshot encoded or decoded
+  vtkGetMacro(SequenceNumber,int);
+
+  // Description:
+  // Get whether the last snapshot encoded or decoded was a keyframe
+  vtkGetMacro(Keyframe,int);
+
+  // Description:
+  // The snapshot format version
+  static int GetFormatVersion();
+
+protected:
+  vtkDeviceStateCodec();
+  ~vtkDeviceStateCodec();
+
+  double PositionPrecision;
+  double RotationPrecision;
+  int KeyframeInterval;
+
+  int SequenceNumber;
+  int Keyframe;
+
+  // Stream for the state of one device
+  vtkDeviceStateStream* DeviceStream;
+
+  vtkDeviceStateCodecInternals* Internals;
+
+private:
+  vtkDeviceStateCodec(const vtkDeviceStateCodec&);  // Not implemented.
+  void operator=(const vtkDeviceStateCodec&);  // Not implemented.
+};
+
+#endif
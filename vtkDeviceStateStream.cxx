@@ -0,0 +1,320 @@
+/*=========================================================================
+
+  Name:        vtkDeviceStateStream.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkDeviceStateStream.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkstd/string"
+#include "vtkstd/vector"
+
+#include <math.h>
+#include <string.h>
+
+class vtkDeviceStateStreamInternals
+{
+public:
+  vtkstd::vector<unsigned char> Buffer;
+
+  // Data read in place, if not NULL
+  const unsigned char* ExternalData;
+  int ExternalSize;
+
+  // Last string read, so ReadString() can return a pointer
+  vtkstd::string String;
+};
+
+vtkCxxRevisionMacro(vtkDeviceStateStream, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDeviceStateStream);
+
+//----------------------------------------------------------------------------
+vtkDeviceStateStream::vtkDeviceStateStream() 
+{
+  this->Internals = new vtkDeviceStateStreamInternals();
+  this->Internals->ExternalData = NULL;
+  this->Internals->ExternalSize = 0;
+
+  this->Position = 0;
+  this->Error = 0;
+
+  this->PositionPrecision = 0.0;
+  this->RotationPrecision = 0.0;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceStateStream::~vtkDeviceStateStream() 
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::Reset() 
+{
+  // Keeps the capacity, so writing doesn't allocate once warmed up
+  this->Internals->Buffer.clear();
+  this->Internals->ExternalData = NULL;
+  this->Internals->ExternalSize = 0;
+  this->Position = 0;
+  this->Error = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::SetData(const void* data, int size) 
+{
+  this->Reset();
+  this->WriteBytes(data, size);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::SetExternalData(const void* data, int size) 
+{
+  this->Reset();
+  this->Internals->ExternalData = static_cast<const unsigned char*>(data);
+  this->Internals->ExternalSize = data ? size : 0;
+}
+
+//----------------------------------------------------------------------------
+const unsigned char* vtkDeviceStateStream::GetData() 
+{
+  if (this->Internals->ExternalData) return this->Internals->ExternalData;
+
+  return this->Internals->Buffer.empty() ? NULL : &this->Internals->Buffer[0];
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceStateStream::GetSize() 
+{
+  if (this->Internals->ExternalData) return this->Internals->ExternalSize;
+
+  return static_cast<int>(this->Internals->Buffer.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceStateStream::GetPosition() 
+{
+  return this->Position;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::SetPosition(int position) 
+{
+  if (position < 0 || position > this->GetSize())
+    {
+    this->Error = 1;
+    return;
+    }
+
+  this->Position = position;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteBytes(const void* data, int size) 
+{
+  if (size <= 0) return;
+
+  vtkstd::vector<unsigned char>& buffer = this->Internals->Buffer;
+
+  // Take a copy of external data before appending to it
+  if (this->Internals->ExternalData)
+    {
+    buffer.assign(this->Internals->ExternalData, this->Internals->ExternalData + this->Internals->ExternalSize);
+    this->Internals->ExternalData = NULL;
+    this->Internals->ExternalSize = 0;
+    }
+
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteInt(int value) 
+{
+  this->WriteBytes(&value, sizeof(int));
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteDouble(double value) 
+{
+  this->WriteBytes(&value, sizeof(double));
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteDoubles(const double* values, int n) 
+{
+  this->WriteBytes(values, n * sizeof(double));
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteString(const char* value) 
+{
+  int length = value ? static_cast<int>(strlen(value)) : 0;
+  this->WriteInt(length);
+  this->WriteBytes(value, length);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteQuantized(const double* values, int n, double precision) 
+{
+  if (precision <= 0.0)
+    {
+    this->WriteDoubles(values, n);
+    return;
+    }
+
+  for (int i = 0; i < n; i++)
+    {
+    double q = floor(values[i] / precision + 0.5);
+    if (q > VTK_INT_MAX) q = VTK_INT_MAX;
+    else if (q < VTK_INT_MIN) q = VTK_INT_MIN;
+
+    this->WriteInt(static_cast<int>(q));
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WritePositions(const double* values, int n) 
+{
+  this->WriteQuantized(values, n, this->PositionPrecision);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteRotations(const double* values, int n) 
+{
+  this->WriteQuantized(values, n, this->RotationPrecision);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::WriteBits(const unsigned char* values, int n) 
+{
+  for (int i = 0; i < n; i += 8)
+    {
+    unsigned char byte = 0;
+    for (int j = 0; j < 8 && i + j < n; j++)
+      {
+      if (values[i + j]) byte |= 1 << j;
+      }
+    this->WriteBytes(&byte, 1);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::ReadBytes(void* data, int size) 
+{
+  if (size <= 0) return;
+
+  if (this->Error || this->Position + size > this->GetSize())
+    {
+    this->Error = 1;
+    memset(data, 0, size);
+    return;
+    }
+
+  memcpy(data, this->GetData() + this->Position, size);
+  this->Position += size;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::ReadQuantized(double* values, int n, double precision) 
+{
+  if (precision <= 0.0)
+    {
+    this->ReadDoubles(values, n);
+    return;
+    }
+
+  for (int i = 0; i < n; i++)
+    {
+    values[i] = this->ReadInt() * precision;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::ReadPositions(double* values, int n) 
+{
+  this->ReadQuantized(values, n, this->PositionPrecision);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::ReadRotations(double* values, int n) 
+{
+  this->ReadQuantized(values, n, this->RotationPrecision);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::ReadBits(unsigned char* values, int n) 
+{
+  for (int i = 0; i < n; i += 8)
+    {
+    unsigned char byte;
+    this->ReadBytes(&byte, 1);
+    for (int j = 0; j < 8 && i + j < n; j++)
+      {
+      values[i + j] = (byte >> j) & 1;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceStateStream::ReadInt() 
+{
+  int value;
+  this->ReadBytes(&value, sizeof(int));
+  return value;
+}
+
+//----------------------------------------------------------------------------
+double vtkDeviceStateStream::ReadDouble() 
+{
+  double value;
+  this->ReadBytes(&value, sizeof(double));
+  return value;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::ReadDoubles(double* values, int n) 
+{
+  this->ReadBytes(values, n * sizeof(double));
+}
+
+//----------------------------------------------------------------------------
+const char* vtkDeviceStateStream::ReadString() 
+{
+  int length = this->ReadInt();
+
+  if (this->Error || length < 0 || this->Position + length > this->GetSize())
+    {
+    this->Error = 1;
+    this->Internals->String = "";
+    }
+  else
+    {
+    this->Internals->String.assign(reinterpret_cast<const char*>(this->GetData()) + this->Position, length);
+    this->Position += length;
+    }
+
+  return this->Internals->String.c_str();
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceStateStream::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Size: " << this->GetSize() << "\n";
+  os << indent << "Position: " << this->Position << "\n";
+  os << indent << "Error: " << this->Error << "\n";
+  os << indent << "PositionPrecision: " << this->PositionPrecision << "\n";
+  os << indent << "RotationPrecision: " << this->RotationPrecision << "\n";
+}
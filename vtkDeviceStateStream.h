@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Name:        vtkDeviceStateStream.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDeviceStateStream
+// .SECTION Description
+// vtkDeviceStateStream is a byte buffer that vtkInteractionDevices write
+// their state to and read it back from, e.g. to share device input 
+// across a cluster with vtkClusterDeviceInteractor.  Values are stored in
+// host byte order.  Reading past the end of the data sets an error flag 
+// and returns zeros.
+//
+// Positions and rotations can be quantized to a fixed precision, storing
+// each as an int instead of a double.  Writer and reader must use the 
+// same precisions.  Flags such as buttons are packed eight to a byte.
+
+// .SECTION see also
+// vtkClusterDeviceInteractor vtkInteractionDevice
+
+#ifndef __vtkDeviceStateStream_h
+#define __vtkDeviceStateStream_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkObject.h"
+
+// Holds vtkstd member variables, which must be hidden
+class vtkDeviceStateStreamInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceStateStream : public vtkObject
+{
+public:
+  static vtkDeviceStateStream* New();
+  vtkTypeRevisionMacro(vtkDeviceStateStream,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Empty the stream for writing
+  void Reset();
+
+  // Description:
+  // Replace the contents of the stream with a copy of data, for reading
+  void SetData(const void* data, int size);
+
+  // Description:
+  // Read data in place, without copying it.  The data must stay valid 
+  // until the stream is reset or written to.
+  void SetExternalData(const void* data, int size);
+
+  // Description:
+  // Get the contents of the stream
+  const unsigned char* GetData();
+  int GetSize();
+
+  // Description:
+  // Get/set the read position
+  int GetPosition();
+  void SetPosition(int position);
+
+  // Description:
+  // Write values to the end of the stream
+  void WriteInt(int value);
+  void WriteDouble(double value);
+  void WriteDoubles(const double* values, int n);
+  void WriteString(const char* value);
+  void WriteBytes(const void* data, int size);
+
+  // Description:
+  // Write positions, or rotation quaternions, quantized to the current 
+  // precision
+  void WritePositions(const double* values, int n);
+  void WriteRotations(const double* values, int n);
+
+  // Description:
+  // Write n flags, one bit each
+  void WriteBits(const unsigned char* values, int n);
+
+  // Description:
+  // Read values from the read position
+  int ReadInt();
+  double ReadDouble();
+  void ReadDoubles(double* values, int n);
+  const char* ReadString();
+  void ReadBytes(void* data, int size);
+  void ReadPositions(double* values, int n);
+  void ReadRotations(double* values, int n);
+  void ReadBits(unsigned char* values, int n);
+
+  // Description:
+  // Set/get the precision positions and rotations are quantized to.  
+  // 0, the default, stores them exactly.
+  vtkSetClampMacro(PositionPrecision,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(PositionPrecision,double);
+  vtkSetClampMacro(RotationPrecision,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(RotationPrecision,double);
+
+  // Description:
+  // Whether a read has gone past the end of the data since the last 
+  // Reset(), SetData() or ClearError()
+  vtkGetMacro(Error,int);
+  void ClearError() { this->Error = 0; }
+
+protected:
+  vtkDeviceStateStream();
+  ~vtkDeviceStateStream();
+
+  vtkDeviceStateStreamInternals* Internals;
+
+  int Position;
+  int Error;
+
+  double PositionPrecision;
+  double RotationPrecision;
+
+  void WriteQuantized(const double* values, int n, double precision);
+  void ReadQuantized(double* values, int n, double precision);
+
+private:
+  vtkDeviceStateStream(const vtkDeviceStateStream&);  // Not implemented.
+  void operator=(const vtkDeviceStateStream&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Name:        vtkDeviceViewTransform.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkDeviceViewTransform.h"
+
+#include "vtkCamera.h"
+#include "vtkMatrix4x4.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+
+vtkCxxRevisionMacro(vtkDeviceViewTransform, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkDeviceViewTransform);
+
+vtkCxxSetObjectMacro(vtkDeviceViewTransform, Renderer, vtkRenderer);
+
+//----------------------------------------------------------------------------
+vtkDeviceViewTransform::vtkDeviceViewTransform() 
+{
+  this->Renderer = NULL;
+
+  vtkMatrix4x4::Identity(this->WorldToDisplayMatrix);
+  vtkMatrix4x4::Identity(this->DisplayToWorldMatrix);
+
+  this->Camera = NULL;
+  this->CameraTime = 0;
+  this->RendererTime = 0;
+  this->Size[0] = this->Size[1] = 0;
+  this->AspectRatio = 0.0;
+
+  this->NumberOfBuilds = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkDeviceViewTransform::~vtkDeviceViewTransform() 
+{
+  this->SetRenderer(NULL);
+}
+
+//----------------------------------------------------------------------------
+int vtkDeviceViewTransform::Update() 
+{
+  if (this->Renderer == NULL || this->Renderer->GetRenderWindow() == NULL) return 0;
+
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+  int* size = this->Renderer->GetRenderWindow()->GetSize();
+  double aspect = this->Renderer->GetTiledAspectRatio();
+
+  if (camera == this->Camera && 
+      camera->GetMTime() == this->CameraTime &&
+      this->Renderer->GetMTime() == this->RendererTime &&
+      size[0] == this->Size[0] && size[1] == this->Size[1] &&
+      aspect == this->AspectRatio)
+    {
+    return 1;
+    }
+
+  this->Camera = camera;
+  this->CameraTime = camera->GetMTime();
+  this->RendererTime = this->Renderer->GetMTime();
+  this->Size[0] = size[0];
+  this->Size[1] = size[1];
+  this->AspectRatio = aspect;
+
+  // World to view, with depth in [0, 1], as in vtkRenderer::WorldToView()
+  vtkMatrix4x4* projection = camera->GetCompositeProjectionTransformMatrix(aspect, 0, 1);
+  const double* p = *projection->Element;
+
+  // View to display is a scale and offset of x and y by the viewport, as
+  // in vtkViewport::ViewToDisplay().  It is applied to the homogeneous 
+  // point, before the divide, so is folded into the projection rows.
+  double* viewport = this->Renderer->GetViewport();
+  double sx = 0.5 * size[0] * (viewport[2] - viewport[0]);
+  double sy = 0.5 * size[1] * (viewport[3] - viewport[1]);
+  double ox = sx + size[0] * viewport[0];
+  double oy = sy + size[1] * viewport[1];
+
+  double* m = this->WorldToDisplayMatrix;
+  for (int j = 0; j < 4; j++)
+    {
+    m[j] = sx * p[j] + ox * p[12 + j];
+    m[4 + j] = sy * p[4 + j] + oy * p[12 + j];
+    m[8 + j] = p[8 + j];
+    m[12 + j] = p[12 + j];
+    }
+
+  vtkMatrix4x4::Invert(this->WorldToDisplayMatrix, this->DisplayToWorldMatrix);
+
+  this->NumberOfBuilds++;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceViewTransform::TransformPoints(const double matrix[16], const double* in, 
+                                             double* out, int numPoints) 
+{
+  // Keep the matrix in locals, so the compiler doesn't reload it for 
+  // fear of aliasing the output
+  const double m0 = matrix[0], m1 = matrix[1], m2 = matrix[2], m3 = matrix[3];
+  const double m4 = matrix[4], m5 = matrix[5], m6 = matrix[6], m7 = matrix[7];
+  const double m8 = matrix[8], m9 = matrix[9], m10 = matrix[10], m11 = matrix[11];
+  const double m12 = matrix[12], m13 = matrix[13], m14 = matrix[14], m15 = matrix[15];
+
+  for (int i = 0; i < numPoints; i++)
+    {
+    const double x = in[3 * i];
+    const double y = in[3 * i + 1];
+    const double z = in[3 * i + 2];
+
+    const double w = 1.0 / (m12 * x + m13 * y + m14 * z + m15);
+    out[3 * i] = (m0 * x + m1 * y + m2 * z + m3) * w;
+    out[3 * i + 1] = (m4 * x + m5 * y + m6 * z + m7) * w;
+    out[3 * i + 2] = (m8 * x + m9 * y + m10 * z + m11) * w;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceViewTransform::WorldToDisplay(double x, double y, double z, double display[3]) 
+{
+  double world[3] = { x, y, z };
+
+  this->Update();
+  vtkDeviceViewTransform::TransformPoints(this->WorldToDisplayMatrix, world, display, 1);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceViewTransform::DisplayToWorld(double x, double y, double z, double world[4]) 
+{
+  double display[3] = { x, y, z };
+
+  this->Update();
+  vtkDeviceViewTransform::TransformPoints(this->DisplayToWorldMatrix, display, world, 1);
+  world[3] = 1.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceViewTransform::WorldToDisplay(const double* world, double* display, int numPoints) 
+{
+  this->Update();
+  vtkDeviceViewTransform::TransformPoints(this->WorldToDisplayMatrix, world, display, numPoints);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceViewTransform::DisplayToWorld(const double* display, double* world, int numPoints) 
+{
+  this->Update();
+  vtkDeviceViewTransform::TransformPoints(this->DisplayToWorldMatrix, display, world, numPoints);
+}
+
+//----------------------------------------------------------------------------
+void vtkDeviceViewTransform::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  os << indent << "NumberOfBuilds: " << this->NumberOfBuilds << "\n";
+}
@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Name:        vtkDeviceViewTransform.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkDeviceViewTransform
+// .SECTION Description
+// vtkDeviceViewTransform converts points between world and display 
+// coordinates for a renderer, like 
+// vtkInteractorObserver::ComputeWorldToDisplay() and 
+// ComputeDisplayToWorld(), but keeps the composite matrices between 
+// calls.  They are rebuilt only when the camera, the renderer or the 
+// window size changes, so a conversion costs a matrix multiply.  
+//
+// The batch conversions take packed xyz arrays, and their loops are 
+// simple enough for the compiler to vectorize.
+
+// .SECTION see also
+// vtkDeviceInteractorStyle vtkDevicePicker
+
+#ifndef __vtkDeviceViewTransform_h
+#define __vtkDeviceViewTransform_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkCamera;
+class vtkRenderer;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkDeviceViewTransform : public vtkObject
+{
+public:
+  static vtkDeviceViewTransform* New();
+  vtkTypeRevisionMacro(vtkDeviceViewTransform,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Set/get the renderer to convert for
+  void SetRenderer(vtkRenderer*);
+  vtkGetObjectMacro(Renderer,vtkRenderer);
+
+  // Description:
+  // Convert a point.  Display z is the depth in [0, 1], as for
+  // ComputeWorldToDisplay().  The world point is homogeneous, with w 1.
+  void WorldToDisplay(double x, double y, double z, double display[3]);
+  void DisplayToWorld(double x, double y, double z, double world[4]);
+
+  // Description:
+  // Convert numPoints packed xyz points
+  void WorldToDisplay(const double* world, double* display, int numPoints);
+  void DisplayToWorld(const double* display, double* world, int numPoints);
+
+  // Description:
+  // Rebuild the matrices if the view has changed.  Called by the 
+  // conversions.  Returns 0 if there is no renderer or render window.
+  int Update();
+
+  // Description:
+  // Get the number of times the matrices have been built
+  vtkGetMacro(NumberOfBuilds,int);
+
+protected:
+  vtkDeviceViewTransform();
+  ~vtkDeviceViewTransform();
+
+  vtkRenderer* Renderer;
+
+  // Row-major composite matrices
+  double WorldToDisplayMatrix[16];
+  double DisplayToWorldMatrix[16];
+
+  // The view the matrices were built for
+  vtkCamera* Camera;
+  unsigned long CameraTime;
+  unsigned long RendererTime;
+  int Size[2];
+  double AspectRatio;
+
+  int NumberOfBuilds;
+
+  // Description:
+  // Multiply packed points by a composite matrix, with the perspective 
+  // divide
+  static void TransformPoints(const double matrix[16], const double* in, double* out, int numPoints);
+
+private:
+  vtkDeviceViewTransform(const vtkDeviceViewTransform&);  // Not implemented.
+  void operator=(const vtkDeviceViewTransform&);  // Not implemented.
+};
+
+#endif
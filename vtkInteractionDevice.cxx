@@ -16,20 +16,235 @@
 
 #include "vtkInteractionDevice.h"
 
+#include "vtkDeviceInteractorStyle.h"
+#include "vtkMutexLock.h"
+#include "vtkTimerLog.h"
+
 vtkCxxRevisionMacro(vtkInteractionDevice, "$Revision: 1.0 $");
 
 //----------------------------------------------------------------------------
 vtkInteractionDevice::vtkInteractionDevice() 
 {
+  this->ConnectionState = vtkInteractionDevice::Uninitialized;
+  this->ReportedConnectionState = vtkInteractionDevice::Uninitialized;
+  this->ConnectionStateLock = vtkSimpleMutexLock::New();
+
+  this->AutoReconnect = 1;
+  this->ReconnectDelay = 1.0;
+  this->MaximumReconnectDelay = 30.0;
+  this->CurrentReconnectDelay = this->ReconnectDelay;
+  this->NextReconnectTime = 0.0;
+
+  this->Threader = vtkMultiThreader::New();
+  this->InitializeThreadId = -1;
+
+  this->NumberOfStyles = 0;
+
+  this->Replica = 0;
+
+  this->NumberOfReports = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkInteractionDevice::~vtkInteractionDevice() 
 {
+  // Subclasses have already joined the initialization thread
+  this->JoinInitializeThread();
+
+  this->Threader->Delete();
+  this->ConnectionStateLock->Delete();
+
+  for (int i = 0; i < this->NumberOfStyles; i++)
+    {
+    this->Styles[i]->UnRegister(this);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkInteractionDevice::AddDeviceInteractorStyle(vtkDeviceInteractorStyle* style, 
+                                                    unsigned long eventMask)
+{
+  if (style == NULL) return;
+
+  for (int i = 0; i < this->NumberOfStyles; i++)
+    {
+    if (this->Styles[i] == style)
+      {
+      this->StyleEventMasks[i] = eventMask;
+      return;
+      }
+    }
+
+  if (this->NumberOfStyles == vtkInteractionDevice::MaximumNumberOfStyles)
+    {
+    vtkErrorMacro(<<"Too many styles.");
+    return;
+    }
+
+  style->Register(this);
+  this->Styles[this->NumberOfStyles] = style;
+  this->StyleEventMasks[this->NumberOfStyles] = eventMask;
+  this->NumberOfStyles++;
+}
+
+//----------------------------------------------------------------------------
+void vtkInteractionDevice::RemoveDeviceInteractorStyle(vtkDeviceInteractorStyle* style)
+{
+  for (int i = 0; i < this->NumberOfStyles; i++)
+    {
+    if (this->Styles[i] == style)
+      {
+      for (int j = i + 1; j < this->NumberOfStyles; j++)
+        {
+        this->Styles[j - 1] = this->Styles[j];
+        this->StyleEventMasks[j - 1] = this->StyleEventMasks[j];
+        }
+      this->NumberOfStyles--;
+
+      style->UnRegister(this);
+
+      return;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkInteractionDevice::DispatchInteractionEvent(unsigned long eid)
+{
+  unsigned long bit = vtkInteractionDevice::EventBit(eid);
+
+  for (int i = 0; i < this->NumberOfStyles; i++)
+    {
+    if (this->StyleEventMasks[i] & bit)
+      {
+      this->Styles[i]->OnDeviceEvent(this, eid);
+      }
+    }
+
+  // Only go through the observer list if anyone has ever observed us
+  if (this->SubjectHelper)
+    {
+    this->InvokeEvent(eid, NULL);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkInteractionDevice::InitializeInBackground()
+{
+  if (this->GetConnectionState() == vtkInteractionDevice::Initializing) return;
+
+  this->JoinInitializeThread();
+
+  this->SetConnectionState(vtkInteractionDevice::Initializing);
+  this->InitializeThreadId = this->Threader->SpawnThread(vtkInteractionDevice::InitializeThread, this);
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkInteractionDevice::InitializeThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkInteractionDevice* self = static_cast<vtkInteractionDevice*>(info->UserData);
+
+  // CheckConnection() will refine this once the main thread sees it
+  if (self->Initialize())
+    {
+    self->SetConnectionState(vtkInteractionDevice::Connecting);
+    }
+  else
+    {
+    self->SetConnectionState(vtkInteractionDevice::Disconnected);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkInteractionDevice::JoinInitializeThread()
+{
+  if (this->InitializeThreadId < 0) return;
+
+  this->Threader->TerminateThread(this->InitializeThreadId);
+  this->InitializeThreadId = -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkInteractionDevice::GetConnectionState()
+{
+  this->ConnectionStateLock->Lock();
+  int state = this->ConnectionState;
+  this->ConnectionStateLock->Unlock();
+
+  return state;
+}
+
+//----------------------------------------------------------------------------
+void vtkInteractionDevice::SetConnectionState(int state)
+{
+  this->ConnectionStateLock->Lock();
+  this->ConnectionState = state;
+  this->ConnectionStateLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkInteractionDevice::UpdateConnectionState()
+{
+  int state = this->GetConnectionState();
+
+  if (state != vtkInteractionDevice::Initializing)
+    {
+    // Any initialization thread has finished, so clean it up
+    this->JoinInitializeThread();
+
+    int current = this->CheckConnection();
+    if (state != vtkInteractionDevice::Uninitialized ||
+        current != vtkInteractionDevice::Disconnected)
+      {
+      // Don't reconnect devices that were never initialized
+      state = current;
+      this->SetConnectionState(state);
+      }
+
+    double time = vtkTimerLog::GetUniversalTime();
+
+    if (state == vtkInteractionDevice::Connected)
+      {
+      this->CurrentReconnectDelay = this->ReconnectDelay;
+      }
+    else if (state == vtkInteractionDevice::Disconnected && 
+             this->ReportedConnectionState == vtkInteractionDevice::Disconnected &&
+             this->AutoReconnect && time >= this->NextReconnectTime)
+      {
+      // The disconnection has been reported, so try again
+      this->NextReconnectTime = time + this->CurrentReconnectDelay;
+      this->CurrentReconnectDelay *= 2.0;
+      if (this->CurrentReconnectDelay > this->MaximumReconnectDelay)
+        {
+        this->CurrentReconnectDelay = this->MaximumReconnectDelay;
+        }
+
+      this->Disconnect();
+      this->InitializeInBackground();
+      state = vtkInteractionDevice::Initializing;
+      }
+    }
+
+  if (state != this->ReportedConnectionState)
+    {
+    this->ReportedConnectionState = state;
+    this->InvokeEvent(vtkInteractionDevice::ConnectionStateChangedEvent, &state);
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkInteractionDevice::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "ConnectionState: " << this->ConnectionState << "\n";
+  os << indent << "AutoReconnect: " << this->AutoReconnect << "\n";
+  os << indent << "ReconnectDelay: " << this->ReconnectDelay << "\n";
+  os << indent << "MaximumReconnectDelay: " << this->MaximumReconnectDelay << "\n";
+  os << indent << "NumberOfStyles: " << this->NumberOfStyles << "\n";
+  os << indent << "Replica: " << this->Replica << "\n";
+  os << indent << "NumberOfReports: " << this->NumberOfReports << "\n";
 }
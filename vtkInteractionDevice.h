@@ -30,6 +30,13 @@
 
 #include "vtkObject.h"
 
+#include "vtkCommand.h"
+#include "vtkMultiThreader.h"
+
+class vtkDeviceInteractorStyle;
+class vtkDeviceStateStream;
+class vtkSimpleMutexLock;
+
 class VTK_INTERACTIONDEVICE_EXPORT vtkInteractionDevice : public vtkObject
 {
 public:
@@ -40,18 +47,162 @@ public:
   // Initialize the device
   virtual int Initialize() = 0;
 
+  // Description:
+  // Call Initialize() on a background thread.  The connection state is
+  // Initializing until it returns.
+  void InitializeInBackground();
+
+  // Description:
+  // Get the state of the connection to the device.  Safe to call from 
+  // any thread.
+  int GetConnectionState();
+
+  // Description:
+  // Check the connection, reinitializing in the background with 
+  // exponential backoff if it has been lost and AutoReconnect is on.
+  // Invokes ConnectionStateChangedEvent when the state has changed.
+  // Called every frame by vtkDeviceInteractor.
+  void UpdateConnectionState();
+
+  // Description:
+  // Reconnection parameters.  The delay between attempts starts at 
+  // ReconnectDelay seconds and doubles up to MaximumReconnectDelay.
+  vtkSetMacro(AutoReconnect,int);
+  vtkGetMacro(AutoReconnect,int);
+  vtkBooleanMacro(AutoReconnect,int);
+  vtkSetMacro(ReconnectDelay,double);
+  vtkGetMacro(ReconnectDelay,double);
+  vtkSetMacro(MaximumReconnectDelay,double);
+  vtkGetMacro(MaximumReconnectDelay,double);
+
   // Description:
   // Receive updates from the device
   virtual void Update() = 0;
 
+  // Description:
+  // Receive input waiting between frames without applying it, so it 
+  // doesn't queue up behind slow renders.  The next Update() applies it.
+  // The default leaves the input for Update().
+  virtual void Poll() {}
+
+  // Description:
+  // Get the number of reports received from the device, e.g. to tell 
+  // whether new input has arrived since a frame.  Devices call 
+  // ReportReceived() for each report that changes their state, so 
+  // devices streaming an unchanged state don't count as new input.
+  vtkGetMacro(NumberOfReports,unsigned long);
+  void ReportReceived() { this->NumberOfReports++; }
+
   // Description:
   // Invoke the appropriate event for observers to listen for
   virtual void InvokeInteractionEvent() = 0;
 
+  // Description:
+  // Write/read the state received in the last Update(), e.g. to share 
+  // device input across a cluster.  Devices without input state don't 
+  // need to implement these.
+  virtual void WriteState(vtkDeviceStateStream*) {}
+  virtual void ReadState(vtkDeviceStateStream*) {}
+
+  // Description:
+  // A replica gets its state from ReadState() instead of Update(), and 
+  // invokes events without being initialized.
+  vtkSetMacro(Replica,int);
+  vtkGetMacro(Replica,int);
+  vtkBooleanMacro(Replica,int);
+
+  // Description:
+  // Subscribe a style to the events in eventMask, a bitwise OR of 
+  // EventBit() for each event wanted.  Events are passed straight to the 
+  // style's OnDeviceEvent(), bypassing the vtkCommand observer list.
+  // Adding a style again replaces its event mask.
+  void AddDeviceInteractorStyle(vtkDeviceInteractorStyle* style, unsigned long eventMask);
+  void RemoveDeviceInteractorStyle(vtkDeviceInteractorStyle* style);
+
+  // Description:
+  // The bit for a device event id in an event mask.  Device event ids 
+  // start at vtkCommand::UserEvent.
+  static unsigned long EventBit(unsigned long eid)
+    {
+    return eid >= vtkCommand::UserEvent && eid < vtkCommand::UserEvent + 32 ?
+           1ul << (eid - vtkCommand::UserEvent) : 0;
+    }
+
+  // Enumeration for connection states
+  //BTX
+  enum ConnectionStates {
+      Uninitialized = 0,
+      Initializing,
+      Connecting,
+      Connected,
+      Disconnected
+  };
+  //ETX
+
+  // Enumeration for events common to all devices.  Offset from the 
+  // subclass event enumerations, which start at vtkCommand::UserEvent.
+  //BTX
+  enum InteractionDeviceEventIds {
+      ConnectionStateChangedEvent = vtkCommand::UserEvent + 1000
+  };
+  //ETX
+
 protected:
   vtkInteractionDevice();
   ~vtkInteractionDevice();
 
+  // Description:
+  // Returns the current state of an initialized connection, or 
+  // Disconnected if there is none.  Devices without a notion of a 
+  // connection are always Connected.
+  virtual int CheckConnection() { return Connected; }
+
+  // Description:
+  // Tear down the connection so Initialize() can be called again
+  virtual void Disconnect() {}
+
+  void SetConnectionState(int state);
+
+  // Description:
+  // Pass an event to the subscribed styles, then to any vtkCommand 
+  // observers.  Subclasses call this from InvokeInteractionEvent().
+  void DispatchInteractionEvent(unsigned long eid);
+
+  //BTX
+  enum { MaximumNumberOfStyles = 16 };
+  //ETX
+  vtkDeviceInteractorStyle* Styles[MaximumNumberOfStyles];
+  unsigned long StyleEventMasks[MaximumNumberOfStyles];
+  int NumberOfStyles;
+
+  int Replica;
+
+  unsigned long NumberOfReports;
+
+  int ConnectionState;
+  int ReportedConnectionState;
+  vtkSimpleMutexLock* ConnectionStateLock;
+
+  int AutoReconnect;
+  double ReconnectDelay;
+  double MaximumReconnectDelay;
+  double CurrentReconnectDelay;
+  double NextReconnectTime;
+
+  vtkMultiThreader* Threader;
+  int InitializeThreadId;
+
+  // Description:
+  // Wait for the background initialization thread to finish.  Concrete 
+  // devices must call this first thing in their destructors, before 
+  // tearing down anything Initialize() uses, as by the time this class's 
+  // destructor runs the subclass parts of the object are gone.
+  void JoinInitializeThread();
+
+  //BTX
+  static VTK_THREAD_RETURN_TYPE InitializeThread(void* arg);
+  //ETX
+
 private:
   vtkInteractionDevice(const vtkInteractionDevice&);  // Not implemented.
   void operator=(const vtkInteractionDevice&);  // Not implemented.
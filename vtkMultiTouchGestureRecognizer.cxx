@@ -0,0 +1,341 @@
+/*=========================================================================
+
+  Name:        vtkMultiTouchGestureRecognizer.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkMultiTouchGestureRecognizer.h"
+
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenciMultiTouch.h"
+
+#include <math.h>
+
+// Touch states
+enum 
+{
+  TouchDown = 0,
+  TouchMoving,
+  TouchResting
+};
+
+struct vtkMultiTouchGestureRecognizerTouch
+{
+  int Id;
+  int State;
+  double Location[2];
+
+  // Location at the last Recognize(), for the direction of motion
+  double FrameLocation[2];
+
+  // Location and time the touch was last seen moving
+  double MoveLocation[2];
+  double MoveTime;
+};
+
+class vtkMultiTouchGestureRecognizerInternals
+{
+public:
+  // Touches down, packed at the front of the table
+  vtkMultiTouchGestureRecognizerTouch Touches[vtkMultiTouchGestureRecognizer::MaximumNumberOfTouches];
+  int NumberOfTouches;
+
+  // Touch points of the last gesture
+  TouchPoint Output[vtkMultiTouchGestureRecognizer::MaximumNumberOfTouches];
+  int NumberOfOutputs;
+
+  // Whether touches have been added or lifted since the last Recognize()
+  int Added;
+  int Lifted;
+
+  // Two touch gesture kept until the touches change
+  int LockedGesture;
+
+  vtkSimpleMutexLock Lock;
+
+  int FindTouch(int id)
+    {
+    for (int i = 0; i < this->NumberOfTouches; i++)
+      {
+      if (this->Touches[i].Id == id) return i;
+      }
+    return -1;
+    }
+};
+
+// Pick between zooming, twisting and dragging two touches, by the 
+// distance each would move the touches
+static int ClassifyTwoTouches(const TouchPoint& t0, const TouchPoint& t1)
+{
+  double previous[2], current[2];
+  for (int i = 0; i < 2; i++)
+    {
+    current[i] = t1.Location[i] - t0.Location[i];
+    previous[i] = (t1.Location[i] - t1.Direction[i]) - (t0.Location[i] - t0.Direction[i]);
+    }
+
+  double separation = sqrt(current[0] * current[0] + current[1] * current[1]);
+  double previousSeparation = sqrt(previous[0] * previous[0] + previous[1] * previous[1]);
+  double zoom = fabs(separation - previousSeparation);
+
+  // Arc length of the twist at the touches
+  double twist = 0.0;
+  if (separation > 0.0 && previousSeparation > 0.0)
+    {
+    double angle = atan2(previous[0] * current[1] - previous[1] * current[0],
+                         previous[0] * current[0] + previous[1] * current[1]);
+    twist = fabs(angle) * separation * 0.5;
+    }
+
+  double drag[2] = { (t0.Direction[0] + t1.Direction[0]) * 0.5, 
+                     (t0.Direction[1] + t1.Direction[1]) * 0.5 };
+  double pan = sqrt(drag[0] * drag[0] + drag[1] * drag[1]);
+
+  if (zoom >= twist && zoom >= pan) return vtkRenciMultiTouch::ZoomEvent;
+  if (twist >= pan) return vtkRenciMultiTouch::RotateZEvent;
+  return vtkRenciMultiTouch::TwoDragEvent;
+}
+
+vtkCxxRevisionMacro(vtkMultiTouchGestureRecognizer, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiTouchGestureRecognizer);
+
+//----------------------------------------------------------------------------
+vtkMultiTouchGestureRecognizer::vtkMultiTouchGestureRecognizer() 
+{
+  this->Internals = new vtkMultiTouchGestureRecognizerInternals;
+  this->Internals->NumberOfTouches = 0;
+  this->Internals->NumberOfOutputs = 0;
+  this->Internals->Added = 0;
+  this->Internals->Lifted = 0;
+  this->Internals->LockedGesture = 0;
+
+  this->MoveThreshold = 0.002;
+  this->HoldTime = 0.1;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiTouchGestureRecognizer::~vtkMultiTouchGestureRecognizer() 
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiTouchGestureRecognizer::SetTouch(int id, double x, double y, double time) 
+{
+  vtkMultiTouchGestureRecognizerInternals* internals = this->Internals;
+
+  internals->Lock.Lock();
+
+  int i = internals->FindTouch(id);
+  if (i < 0)
+    {
+    if (internals->NumberOfTouches == MaximumNumberOfTouches)
+      {
+      internals->Lock.Unlock();
+      return 0;
+      }
+
+    i = internals->NumberOfTouches++;
+
+    vtkMultiTouchGestureRecognizerTouch& touch = internals->Touches[i];
+    touch.Id = id;
+    touch.State = TouchDown;
+    touch.Location[0] = touch.FrameLocation[0] = touch.MoveLocation[0] = x;
+    touch.Location[1] = touch.FrameLocation[1] = touch.MoveLocation[1] = y;
+    touch.MoveTime = time;
+
+    internals->Added = 1;
+    }
+  else
+    {
+    vtkMultiTouchGestureRecognizerTouch& touch = internals->Touches[i];
+    touch.Location[0] = x;
+    touch.Location[1] = y;
+
+    double dx = x - touch.MoveLocation[0];
+    double dy = y - touch.MoveLocation[1];
+    if (dx * dx + dy * dy > this->MoveThreshold * this->MoveThreshold)
+      {
+      touch.State = TouchMoving;
+      touch.MoveLocation[0] = x;
+      touch.MoveLocation[1] = y;
+      touch.MoveTime = time;
+      }
+    }
+
+  internals->Lock.Unlock();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiTouchGestureRecognizer::RemoveTouch(int id) 
+{
+  vtkMultiTouchGestureRecognizerInternals* internals = this->Internals;
+
+  internals->Lock.Lock();
+
+  int i = internals->FindTouch(id);
+  if (i >= 0)
+    {
+    // Keep the table packed
+    internals->Touches[i] = internals->Touches[--internals->NumberOfTouches];
+    internals->Lifted = 1;
+    }
+
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiTouchGestureRecognizer::RemoveAllTouches() 
+{
+  this->Internals->Lock.Lock();
+  if (this->Internals->NumberOfTouches > 0) this->Internals->Lifted = 1;
+  this->Internals->NumberOfTouches = 0;
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiTouchGestureRecognizer::Recognize(double time) 
+{
+  vtkMultiTouchGestureRecognizerInternals* internals = this->Internals;
+
+  internals->Lock.Lock();
+
+  int n = internals->NumberOfTouches;
+  int numMovers = 0;
+  int mover = -1;
+
+  // Advance the touch states and report motion since the last frame
+  for (int i = 0; i < n; i++)
+    {
+    vtkMultiTouchGestureRecognizerTouch& touch = internals->Touches[i];
+    if (touch.State == TouchMoving && time - touch.MoveTime > this->HoldTime)
+      {
+      touch.State = TouchResting;
+      }
+
+    TouchPoint& tp = internals->Output[i];
+    tp.Id = touch.Id;
+    tp.Location[0] = touch.Location[0];
+    tp.Location[1] = touch.Location[1];
+    tp.Direction[0] = touch.Location[0] - touch.FrameLocation[0];
+    tp.Direction[1] = touch.Location[1] - touch.FrameLocation[1];
+    tp.MoveLocation = touch.State == TouchMoving;
+
+    touch.FrameLocation[0] = touch.Location[0];
+    touch.FrameLocation[1] = touch.Location[1];
+
+    if (tp.MoveLocation)
+      {
+      numMovers++;
+      mover = i;
+      }
+    }
+  internals->NumberOfOutputs = n;
+
+  if (internals->Added || internals->Lifted) internals->LockedGesture = 0;
+  int lifted = internals->Lifted;
+  internals->Added = 0;
+  internals->Lifted = 0;
+
+  int gesture = 0;
+  int count = n < 6 ? n : 6;
+  int numAnchors = n - numMovers;
+
+  if (n == 0)
+    {
+    gesture = lifted ? vtkRenciMultiTouch::ReleaseEvent : 0;
+    }
+  else if (numMovers == 0)
+    {
+    gesture = vtkRenciMultiTouch::OneTouchEvent + 2 * (count - 1);
+    }
+  else if (numAnchors == 0 && n == 2)
+    {
+    if (internals->LockedGesture == 0)
+      {
+      internals->LockedGesture = ClassifyTwoTouches(internals->Output[0], internals->Output[1]);
+      }
+    gesture = internals->LockedGesture;
+    }
+  else if (numAnchors == 0)
+    {
+    gesture = vtkRenciMultiTouch::OneDragEvent + 2 * (count - 1);
+    }
+  else if (numMovers == 1 && numAnchors <= 2)
+    {
+    // Which side of the anchors the mover is on.  There is at least one 
+    // anchor here.
+    double anchorX = 0.0;
+    for (int i = 0; i < n; i++)
+      {
+      if (i != mover) anchorX += internals->Output[i].Location[0];
+      }
+    anchorX /= numAnchors;
+    int right = internals->Output[mover].Location[0] > anchorX;
+
+    if (numAnchors == 1)
+      {
+      gesture = right ? vtkRenciMultiTouch::RotateXEvent : vtkRenciMultiTouch::RotateYEvent;
+      }
+    else
+      {
+      gesture = right ? vtkRenciMultiTouch::TranslateXEvent : vtkRenciMultiTouch::TranslateYEvent;
+      }
+    }
+  else if (numMovers == 1)
+    {
+    gesture = vtkRenciMultiTouch::TranslateZEvent;
+    }
+  else
+    {
+    gesture = vtkRenciMultiTouch::OneDragEvent + 2 * (count - 1);
+    }
+
+  internals->Lock.Unlock();
+
+  return gesture;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiTouchGestureRecognizer::GetNumberOfTouchPoints() 
+{
+  return this->Internals->NumberOfOutputs;
+}
+
+//----------------------------------------------------------------------------
+const TouchPoint& vtkMultiTouchGestureRecognizer::GetTouchPoint(int which) 
+{
+  return this->Internals->Output[which];
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiTouchGestureRecognizer::GetNumberOfTouches() 
+{
+  this->Internals->Lock.Lock();
+  int n = this->Internals->NumberOfTouches;
+  this->Internals->Lock.Unlock();
+
+  return n;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiTouchGestureRecognizer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "MoveThreshold: " << this->MoveThreshold << "\n";
+  os << indent << "HoldTime: " << this->HoldTime << "\n";
+  os << indent << "NumberOfTouches: " << this->Internals->NumberOfTouches << "\n";
+}
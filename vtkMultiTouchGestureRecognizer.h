@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Name:        vtkMultiTouchGestureRecognizer.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiTouchGestureRecognizer
+// .SECTION Description
+// vtkMultiTouchGestureRecognizer classifies raw touch points into the 
+// gestures of vtkRenciMultiTouch, so gestures can be recognized in 
+// process, with thresholds tuned per application, instead of by an 
+// external gesture server.
+//
+// Feed touches with SetTouch() and RemoveTouch(), then call Recognize() 
+// once per frame.  Each touch runs a small state machine:  it is Down 
+// until it first moves more than MoveThreshold, then Moving while it 
+// keeps moving, and Resting once it has been still for HoldTime.  Moving
+// touches are movers, the others anchors, and the gesture follows from 
+// their numbers and arrangement:
+//
+//   no movers                       N_touch (N touches)
+//   all movers, 2 touches           zoom, about_Z_axis or two_drag, 
+//                                   whichever motion dominates
+//   all movers                      N_drag
+//   1 mover, 1 anchor               about_X_axis if the mover is right of
+//                                   the anchor, about_Y_axis if left
+//   1 mover, 2 anchors              translate_x if the mover is right of
+//                                   the anchors, translate_y if left
+//   1 mover, 3 or more anchors      translate_z
+//   several movers and anchors      N_drag
+//   all touches lifted              release
+//
+// A two touch gesture is kept until a touch is added or removed, so 
+// zooming doesn't flicker into rotating.  Reported touch points have 
+// their motion since the last Recognize() as their direction.
+//
+// Touches are kept in a fixed size table, so nothing is allocated after 
+// construction.  Touches can be fed from a different thread than the 
+// one calling Recognize().
+
+// .SECTION see also
+// vtkRenciMultiTouch
+
+#ifndef __vtkMultiTouchGestureRecognizer_h
+#define __vtkMultiTouchGestureRecognizer_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkObject.h"
+
+struct TouchPoint;
+
+// Holds the touch table, which is hidden
+class vtkMultiTouchGestureRecognizerInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkMultiTouchGestureRecognizer : public vtkObject
+{
+public:
+  static vtkMultiTouchGestureRecognizer* New();
+  vtkTypeRevisionMacro(vtkMultiTouchGestureRecognizer,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Add a touch, or move it if it is already down.  Locations are 
+  // normalized to [0, 1] over the touch surface.  Time is in seconds, 
+  // from vtkTimerLog::GetUniversalTime() when used with 
+  // vtkRenciMultiTouch.  Returns 0 if the touch table is full.
+  int SetTouch(int id, double x, double y, double time);
+
+  // Description:
+  // Lift a touch
+  void RemoveTouch(int id);
+  void RemoveAllTouches();
+
+  // Description:
+  // Classify the current touches.  Returns the vtkRenciMultiTouch event 
+  // id of the gesture, or 0 if there is none.
+  int Recognize(double time);
+
+  // Description:
+  // Get the touch points of the last gesture recognized
+  int GetNumberOfTouchPoints();
+  //BTX
+  const TouchPoint& GetTouchPoint(int which);
+  //ETX
+
+  // Description:
+  // Get the number of touches down
+  int GetNumberOfTouches();
+
+  // Description:
+  // Distance a touch must move, in normalized units, to count as moving
+  vtkSetClampMacro(MoveThreshold,double,0.0,1.0);
+  vtkGetMacro(MoveThreshold,double);
+
+  // Description:
+  // Time in seconds a moving touch must be still to become an anchor
+  vtkSetClampMacro(HoldTime,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(HoldTime,double);
+
+  //BTX
+  enum { MaximumNumberOfTouches = 64 };
+  //ETX
+
+protected:
+  vtkMultiTouchGestureRecognizer();
+  ~vtkMultiTouchGestureRecognizer();
+
+  double MoveThreshold;
+  double HoldTime;
+
+  vtkMultiTouchGestureRecognizerInternals* Internals;
+
+private:
+  vtkMultiTouchGestureRecognizer(const vtkMultiTouchGestureRecognizer&);  // Not implemented.
+  void operator=(const vtkMultiTouchGestureRecognizer&);  // Not implemented.
+};
+
+#endif
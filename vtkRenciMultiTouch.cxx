@@ -16,17 +16,152 @@
 
 #include "vtkRenciMultiTouch.h"
 
+#include "vtkDeviceStateStream.h"
+#include "vtkMultiTouchGestureRecognizer.h"
 #include "vtkObjectFactory.h"
-#include "vtkstd/string"
+#include "vtkTimerLog.h"
+#include "vtkstd/algorithm"
 #include "vtkstd/vector"
 
+#include <math.h>
+#include <string.h>
+
+// A gesture and the time it applies at
+struct vtkRenciGesture
+{
+  int EventId;
+  double Time;
+  vtkstd::vector<TouchPoint> TouchPoints;
+
+  bool operator<(const vtkRenciGesture& other) const
+    {
+    return this->Time < other.Time;
+    }
+};
+
 class vtkRenciMultiTouchInternals
 {
 public:
-  vtkstd::string GestureName;
-  vtkstd::vector<TouchPoint> TouchPoints;
+  // Gestures due this update.  Slots are reused across updates, so their
+  // touch point vectors keep their capacity.
+  vtkstd::vector<vtkRenciGesture> Gestures;
+  int NumberOfGestures;
+
+  // The gesture being dispatched, or -1 if there is none
+  int CurrentGesture;
+
+  // Gestures timetagged for later updates, in time order
+  vtkstd::vector<vtkRenciGesture> Queue;
+
+  // Tracked touches, packed at the front of the array
+  TrackedTouch Touches[vtkRenciMultiTouch::MaximumNumberOfTrackedTouches];
+  int NumberOfTouches;
+
+  // Indices of the touches that changed phase this update
+  int Moved[vtkRenciMultiTouch::MaximumNumberOfTrackedTouches];
+  int NumberOfMoved;
+  int NumberOfBegan;
+  int NumberOfEnded;
+
+  // Open addressing table from touch id to index in Touches, -1 if empty.
+  // Twice the size of Touches, so probes stay short and always end.
+  enum { TableBits = 7, TableSize = 1 << TableBits, TableMask = TableSize - 1 };
+  int Table[TableSize];
+
+  unsigned int Hash(int id)
+    {
+    // Fibonacci hashing spreads sequential ids over the table
+    return (static_cast<unsigned int>(id) * 2654435761u) >> (32 - TableBits);
+    }
+
+  // The slot holding id, or the empty slot where it would go
+  unsigned int FindSlot(int id)
+    {
+    unsigned int slot = this->Hash(id);
+    while (this->Table[slot] != -1 && this->Touches[this->Table[slot]].Id != id)
+      {
+      slot = (slot + 1) & TableMask;
+      }
+    return slot;
+    }
+
+  void RemoveTouch(int index)
+    {
+    // Empty the touch's slot, shifting back later entries of its probe 
+    // run that can no longer be reached past the hole
+    unsigned int hole = this->FindSlot(this->Touches[index].Id);
+    for (unsigned int next = (hole + 1) & TableMask; this->Table[next] != -1; next = (next + 1) & TableMask)
+      {
+      unsigned int home = this->Hash(this->Touches[this->Table[next]].Id);
+      if (((next - home) & TableMask) >= ((next - hole) & TableMask))
+        {
+        this->Table[hole] = this->Table[next];
+        hole = next;
+        }
+      }
+    this->Table[hole] = -1;
+
+    // Move the last touch into the gap
+    int last = --this->NumberOfTouches;
+    if (index != last)
+      {
+      this->Touches[index] = this->Touches[last];
+      this->Table[this->FindSlot(this->Touches[index].Id)] = index;
+      }
+    }
+
+  vtkRenciGesture& AddGesture()
+    {
+    if (this->NumberOfGestures == static_cast<int>(this->Gestures.size()))
+      {
+      this->Gestures.resize(this->NumberOfGestures + 1);
+      this->Gestures.back().TouchPoints.reserve(vtkMultiTouchGestureRecognizer::MaximumNumberOfTouches);
+      }
+
+    vtkRenciGesture& gesture = this->Gestures[this->NumberOfGestures++];
+    gesture.EventId = 0;
+    gesture.Time = 0.0;
+    gesture.TouchPoints.clear();
+
+    // The latest gesture is current until the gestures are dispatched
+    this->CurrentGesture = this->NumberOfGestures - 1;
+
+    return gesture;
+    }
 };
 
+// Server gesture names, in event id order
+static const char* GestureNames[] = 
+{
+  "one_touch", "one_drag", "two_touch", "two_drag", "three_touch", "three_drag",
+  "four_touch", "four_drag", "five_touch", "five_drag", "six_touch", "six_drag",
+  "zoom", "translate_x", "translate_y", "translate_z", 
+  "about_X_axis", "about_Y_axis", "about_Z_axis", "release"
+};
+static const int NumberOfGestureNames = sizeof(GestureNames) / sizeof(GestureNames[0]);
+
+// Weight of the newest move in the smoothed touch velocity
+static const double VelocitySmoothing = 0.5;
+
+// Seconds from the NTP epoch (1900), used by OSC timetags, to the Unix 
+// epoch (1970), used by vtkTimerLog::GetUniversalTime()
+static const double NTPToUnixSeconds = 2208988800.0;
+
+// Read an OSC string, padded to 4 bytes.  Returns 0 if it runs past end.
+static int ReadOSCString(const char*& data, const char* end, const char*& value)
+{
+  const char* terminator = static_cast<const char*>(memchr(data, '\0', end - data));
+  if (terminator == NULL) return 0;
+
+  value = data;
+
+  int length = static_cast<int>(terminator - data) + 1;
+  data += (length + 3) & ~3;
+  if (data > end) data = end;
+
+  return 1;
+}
+
 vtkCxxRevisionMacro(vtkRenciMultiTouch, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkRenciMultiTouch);
 
@@ -34,20 +169,39 @@ vtkStandardNewMacro(vtkRenciMultiTouch);
 vtkRenciMultiTouch::vtkRenciMultiTouch() 
 {
   this->Internals = new vtkRenciMultiTouchInternals();
+  this->Internals->NumberOfGestures = 0;
+  this->Internals->CurrentGesture = -1;
+  this->Internals->NumberOfTouches = 0;
+  this->Internals->NumberOfMoved = 0;
+  this->Internals->NumberOfBegan = 0;
+  this->Internals->NumberOfEnded = 0;
+  for (int i = 0; i < vtkRenciMultiTouchInternals::TableSize; i++)
+    {
+    this->Internals->Table[i] = -1;
+    }
 
   this->HostName = NULL;
   this->Port = -1;
-  this->SocketDescriptor = 0;
+  this->SocketDescriptor = -1;
+
+  this->MaximumDelay = 1.0;
+
+  this->PredictionHorizon = 0.0;
+  this->MaximumPredictionDistance = 0.05;
+
+  this->GestureRecognizer = NULL;
 }
 
 //----------------------------------------------------------------------------
 vtkRenciMultiTouch::~vtkRenciMultiTouch() 
 {
+  // Initialize() may still be running on the background thread
+  this->JoinInitializeThread();
+
   this->SetHostName(NULL);
+  this->SetGestureRecognizer(NULL);
 #ifdef WIN32
-  closesocket(this->SocketDescriptor);
-#else
-  vtkErrorMacro(<<"Multi-touch currently only implemented on 32-bit Windows");
+  if (this->SocketDescriptor != -1) closesocket(this->SocketDescriptor);
 #endif
 
   delete this->Internals;
@@ -56,6 +210,9 @@ vtkRenciMultiTouch::~vtkRenciMultiTouch()
 //----------------------------------------------------------------------------
 int vtkRenciMultiTouch::Initialize() 
 {
+  // Gestures can come from the recognizer alone
+  if (this->GestureRecognizer && this->HostName == NULL) return 1;
+
  // Initialize the socket library
 #ifdef WIN32
   WORD versionRequested;
@@ -101,158 +258,343 @@ void vtkRenciMultiTouch::Update()
 {
   this->ClearGesture();
 
-  // Read from the socket
-  const int bufferSize = 16384;   // Magic number, taken from OSC MAX_UDP_PACKET_SIZE
-  char buffer[bufferSize];
-  memset(buffer, '\0', bufferSize);
+  if (this->SocketDescriptor != -1)
+    {
+    this->ReceiveGesture();
+    }
 
-  int numBytes = this->Receive(buffer, bufferSize);
+  vtkRenciMultiTouchInternals* internals = this->Internals;
+  double now = vtkTimerLog::GetUniversalTime();
 
-  if (numBytes <= 0 || numBytes > bufferSize)
+  // Take the gestures that are due, in time order
+  unsigned int due = 0;
+  while (due < internals->Queue.size() && internals->Queue[due].Time <= now)
     {
-    return;
+    const vtkRenciGesture& queued = internals->Queue[due++];
+
+    vtkRenciGesture& gesture = internals->AddGesture();
+    gesture.EventId = queued.EventId;
+    gesture.Time = queued.Time;
+    gesture.TouchPoints = queued.TouchPoints;
+    }
+  internals->Queue.erase(internals->Queue.begin(), internals->Queue.begin() + due);
+
+  // A gesture from the server takes precedence
+  if (this->GestureRecognizer && internals->NumberOfGestures == 0)
+    {
+    int eventId = this->GestureRecognizer->Recognize(now);
+    if (eventId != 0)
+      {
+      vtkRenciGesture& gesture = internals->AddGesture();
+      gesture.EventId = eventId;
+      gesture.Time = now;
+      for (int i = 0; i < this->GestureRecognizer->GetNumberOfTouchPoints(); i++)
+        {
+        gesture.TouchPoints.push_back(this->GestureRecognizer->GetTouchPoint(i));
+        }
+      }
     }
 
-  // Tokenize
-  this->ParseBuffer(buffer, numBytes);
+  this->TrackTouches();
 }
 
 //----------------------------------------------------------------------------
-void vtkRenciMultiTouch::InvokeInteractionEvent() 
+void vtkRenciMultiTouch::Poll() 
 {
-  if (this->Internals->GestureName == "") return;
-
-  if (this->Internals->GestureName == "one_touch")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::OneTouchEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "one_drag")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::OneDragEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "two_touch")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::TwoTouchEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "two_drag")
+  if (this->SocketDescriptor != -1)
     {
-    this->InvokeEvent(vtkRenciMultiTouch::TwoDragEvent,NULL);
+    this->ReceiveGesture();
     }
-  else if (this->Internals->GestureName == "three_touch")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::ThreeTouchEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "three_drag")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::ThreeDragEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "four_touch")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::FourTouchEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "four_drag")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::FourDragEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "five_touch")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::FiveTouchEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "five_drag")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::FiveDragEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "six_touch")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::SixTouchEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "six_drag")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::SixDragEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "zoom")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::ZoomEvent,NULL);
-    }
-  else if (this->Internals->GestureName == "translate_x")
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::ReceiveGesture() 
+{
+  // Read from the socket
+  const int bufferSize = 16384;   // Magic number, taken from OSC MAX_UDP_PACKET_SIZE
+  char buffer[bufferSize];
+
+  // Read every waiting datagram, so gestures don't fall behind
+  while (1)
     {
-    this->InvokeEvent(vtkRenciMultiTouch::TranslateXEvent,NULL);
+    int numBytes = this->Receive(buffer, bufferSize);
+
+    if (numBytes <= 0 || numBytes > bufferSize)
+      {
+      return;
+      }
+
+    this->ParsePacket(buffer, numBytes, vtkTimerLog::GetUniversalTime());
     }
-  else if (this->Internals->GestureName == "translate_y")
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::InvokeInteractionEvent() 
+{
+  if (this->Internals->NumberOfBegan > 0)
     {
-    this->InvokeEvent(vtkRenciMultiTouch::TranslateYEvent,NULL);
+    this->DispatchInteractionEvent(vtkRenciMultiTouch::TouchBeginEvent);
     }
-  else if (this->Internals->GestureName == "translate_z")
+  if (this->Internals->NumberOfMoved > 0)
     {
-    this->InvokeEvent(vtkRenciMultiTouch::TranslateZEvent,NULL);
+    this->DispatchInteractionEvent(vtkRenciMultiTouch::TouchMoveEvent);
     }
-  else if (this->Internals->GestureName == "about_X_axis")
+
+  // Dispatch each gesture due this update in turn, making it current so 
+  // the styles see its touch points
+  for (int i = 0; i < this->Internals->NumberOfGestures; i++)
     {
-    this->InvokeEvent(vtkRenciMultiTouch::RotateYEvent,NULL);
+    this->Internals->CurrentGesture = i;
+    this->DispatchInteractionEvent(this->Internals->Gestures[i].EventId);
     }
-  else if (this->Internals->GestureName == "about_Y_axis")
+
+  if (this->Internals->NumberOfEnded > 0)
     {
-    this->InvokeEvent(vtkRenciMultiTouch::RotateYEvent,NULL);
+    this->DispatchInteractionEvent(vtkRenciMultiTouch::TouchEndEvent);
     }
-  else if (this->Internals->GestureName == "about_Z_axis")
-    {
-    this->InvokeEvent(vtkRenciMultiTouch::RotateZEvent,NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::WriteState(vtkDeviceStateStream* stream) 
+{
+  stream->WriteInt(this->Internals->NumberOfGestures);
+  for (int i = 0; i < this->Internals->NumberOfGestures; i++)
+    {
+    const vtkRenciGesture& gesture = this->Internals->Gestures[i];
+    stream->WriteInt(gesture.EventId);
+    stream->WriteDouble(gesture.Time);
+
+    int n = static_cast<int>(gesture.TouchPoints.size());
+    stream->WriteInt(n);
+    for (int j = 0; j < n; j++)
+      {
+      const TouchPoint& tp = gesture.TouchPoints[j];
+      stream->WriteInt(tp.Id);
+      stream->WritePositions(tp.Location, 2);
+
+      // The motion since the last update, in the same units as the 
+      // location.  Styles scale it up, so it needs position precision.
+      stream->WritePositions(tp.Direction, 2);
+      stream->WriteInt(tp.MoveLocation);
+      }
     }
-  else if (this->Internals->GestureName == "release")
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::ReadState(vtkDeviceStateStream* stream) 
+{
+  this->ClearGesture();
+
+  int numGestures = stream->ReadInt();
+  for (int i = 0; i < numGestures && !stream->GetError(); i++)
     {
-    this->InvokeEvent(vtkRenciMultiTouch::ReleaseEvent,NULL);
+    vtkRenciGesture& gesture = this->Internals->AddGesture();
+    gesture.EventId = stream->ReadInt();
+    gesture.Time = stream->ReadDouble();
+
+    int n = stream->ReadInt();
+    for (int j = 0; j < n && !stream->GetError(); j++)
+      {
+      TouchPoint tp;
+      tp.Id = stream->ReadInt();
+      stream->ReadPositions(tp.Location, 2);
+      stream->ReadPositions(tp.Direction, 2);
+      tp.MoveLocation = stream->ReadInt();
+
+      gesture.TouchPoints.push_back(tp);
+      }
     }
+
+  if (stream->GetError()) this->ClearGesture();
+
+  // Touches follow from the gestures, so they aren't replicated
+  this->TrackTouches();
 }
 
 //----------------------------------------------------------------------------  
 int vtkRenciMultiTouch::GetNumberOfTouchPoints()
 {
-  return this->Internals->TouchPoints.size();
+  if (this->Internals->CurrentGesture < 0) return 0;
+
+  return this->Internals->Gestures[this->Internals->CurrentGesture].TouchPoints.size();
 }
 
 //----------------------------------------------------------------------------  
 const TouchPoint& vtkRenciMultiTouch::GetTouchPoint(int which)
 {
-  return this->Internals->TouchPoints[which];
+  return this->Internals->Gestures[this->Internals->CurrentGesture].TouchPoints[which];
 }
 
-//----------------------------------------------------------------------------
-void vtkRenciMultiTouch::ParseBuffer(char* buffer, int numBytes)
+//----------------------------------------------------------------------------  
+int vtkRenciMultiTouch::GetGestureEventId()
 {
-  // Create a vtkStdString to make parsing certain things easier
-  vtkstd::string s(buffer, numBytes);
+  if (this->Internals->CurrentGesture < 0) return 0;
+
+  return this->Internals->Gestures[this->Internals->CurrentGesture].EventId;
+}
 
-  // Flag for the end of osc header junk
-  const vtkstd::string start_flag = "set";
+//----------------------------------------------------------------------------  
+int vtkRenciMultiTouch::GetNumberOfTrackedTouches()
+{
+  return this->Internals->NumberOfTouches;
+}
 
-  // Find our start position  
-  unsigned int si = 0;
-  while (si < s.size() - start_flag.size() && (s.substr(si, start_flag.size())).compare(start_flag) != 0)
+//----------------------------------------------------------------------------  
+const TrackedTouch& vtkRenciMultiTouch::GetTrackedTouch(int which)
+{
+  return this->Internals->Touches[which];
+}
+
+//----------------------------------------------------------------------------  
+const TrackedTouch* vtkRenciMultiTouch::FindTrackedTouch(int id)
+{
+  int index = this->Internals->Table[this->Internals->FindSlot(id)];
+  if (index < 0) return NULL;
+
+  // Touches that ended this update are kept until the next, but are up
+  const TrackedTouch& touch = this->Internals->Touches[index];
+  return touch.Phase == vtkRenciMultiTouch::TouchEnded ? NULL : &touch;
+}
+
+//----------------------------------------------------------------------------  
+int vtkRenciMultiTouch::GetNumberOfMovedTouches()
+{
+  return this->Internals->NumberOfMoved;
+}
+
+//----------------------------------------------------------------------------  
+const TrackedTouch& vtkRenciMultiTouch::GetMovedTouch(int which)
+{
+  return this->Internals->Touches[this->Internals->Moved[which]];
+}
+
+//----------------------------------------------------------------------------  
+int vtkRenciMultiTouch::GetPredictedTouchPoint(int which, TouchPoint& touchPoint)
+{
+  touchPoint = this->GetTouchPoint(which);
+
+  if (this->PredictionHorizon <= 0.0) return 0;
+
+  const TrackedTouch* touch = this->FindTrackedTouch(touchPoint.Id);
+  if (touch == NULL) return 0;
+
+  int last = this->Internals->CurrentGesture == this->Internals->NumberOfGestures - 1;
+  for (int i = 0; i < 2; i++)
     {
-    si++;
+    touchPoint.Location[i] = touch->PredictedLocation[i];
+    touchPoint.Direction[i] = last ? touch->PredictedDirection[i] : 0.0;
     }
 
-  // Skip past start_flag
-  si += (int)start_flag.size() + 1;
+  return 1;
+}
+
+//----------------------------------------------------------------------------  
+double vtkRenciMultiTouch::GetGestureTime()
+{
+  if (this->Internals->CurrentGesture < 0) return 0.0;
+
+  return this->Internals->Gestures[this->Internals->CurrentGesture].Time;
+}
+
+//----------------------------------------------------------------------------  
+int vtkRenciMultiTouch::GetNumberOfQueuedGestures()
+{
+  return this->Internals->Queue.size();
+}
+
+//----------------------------------------------------------------------------  
+const char* vtkRenciMultiTouch::GetGestureName(int eventId)
+{
+  int i = eventId - vtkRenciMultiTouch::OneTouchEvent;
+  if (i < 0 || i >= NumberOfGestureNames) return "";
 
-  vtkstd::string str = s.substr(si);
+  return GestureNames[i];
+}
 
-  // Find the gesture type
-  this->Internals->GestureName = str.substr(0, str.find_first_of('\0'));
+//----------------------------------------------------------------------------  
+vtkCxxSetObjectMacro(vtkRenciMultiTouch, GestureRecognizer, vtkMultiTouchGestureRecognizer);
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::ParsePacket(const char* data, int size, double time)
+{
+  if (size >= 16 && memcmp(data, "#bundle", 8) == 0)
+    {
+    const char* bufPtr = data + 8;
+    const char* end = data + size;
+
+    // The timetag applies to every element, unless it is "immediately"
+    unsigned int seconds = static_cast<unsigned int>(this->ReadInt(&bufPtr));
+    unsigned int fraction = static_cast<unsigned int>(this->ReadInt(&bufPtr));
+    if (seconds != 0 || fraction != 1)
+      {
+      time = seconds - NTPToUnixSeconds + fraction / 4294967296.0;
+      }
+
+    // Elements are messages or nested bundles, each preceded by its size
+    while (end - bufPtr >= 4)
+      {
+      int elementSize = this->ReadInt(&bufPtr);
+      if (elementSize <= 0 || elementSize > end - bufPtr) break;
+
+      this->ParsePacket(bufPtr, elementSize, time);
+      bufPtr += elementSize;
+      }
+    }
+  else if (size > 0 && data[0] == '/')
+    {
+    this->ParseMessage(data, size, time);
+    }
+}
 
-  if (this->Internals->GestureName == "release")
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::ParseMessage(const char* data, int size, double time)
+{
+  const char* bufPtr = data;
+  const char* end = data + size;
+
+  // Address, type tags, "set" and the gesture name
+  const char* address;
+  const char* typeTags;
+  const char* command;
+  const char* gestureName;
+  if (!ReadOSCString(bufPtr, end, address) ||
+      !ReadOSCString(bufPtr, end, typeTags) || typeTags[0] != ',' ||
+      !ReadOSCString(bufPtr, end, command) || strcmp(command, "set") != 0 ||
+      !ReadOSCString(bufPtr, end, gestureName))
     {
-    // No more info.  Return.
     return;
     }
 
-  // Skip to next 4 byte chunk after the gesture name (including '\0')
-  int chunkDist = 4 - ((int)this->Internals->GestureName.size() + 1) % 4;
-  if (chunkDist == 4) chunkDist = 0;
-  char* bufPtr = buffer + si + this->Internals->GestureName.size() + 1 + chunkDist;
+  int eventId = 0;
+  for (int i = 0; i < NumberOfGestureNames; i++)
+    {
+    if (strcmp(gestureName, GestureNames[i]) == 0)
+      {
+      eventId = vtkRenciMultiTouch::OneTouchEvent + i;
+      break;
+      }
+    }
+  if (eventId == 0) return;
 
-  // Get the number of touches
-  int numTouches = this->ReadInt(&bufPtr);
+  // Get the number of touches.  Release gestures have none.
+  int numTouches = 0;
+  if (eventId != vtkRenciMultiTouch::ReleaseEvent)
+    {
+    // Each touch is an id, four doubles and a flag
+    const int touchSize = 4 + 4 * 8 + 4;
+    if (end - bufPtr < 4) return;
+    numTouches = this->ReadInt(&bufPtr);
+    if (numTouches < 0 || numTouches > (end - bufPtr) / touchSize) return;
+    }
+
+  // Gestures timetagged too far ahead come from a sender whose clock is
+  // off, so apply them as they arrive
+  double now = vtkTimerLog::GetUniversalTime();
+  if (time > now + this->MaximumDelay) time = now;
+
+  vtkRenciGesture gesture;
+  gesture.EventId = eventId;
+  gesture.Time = time;
 
   for (int i = 0; i < numTouches; i++) 
     {
@@ -266,15 +608,174 @@ void vtkRenciMultiTouch::ParseBuffer(char* buffer, int numBytes)
     tp.Direction[1] = this->ReadDouble(&bufPtr);
     tp.MoveLocation = this->ReadInt(&bufPtr);
 
-    this->Internals->TouchPoints.push_back(tp);
+    gesture.TouchPoints.push_back(tp);
     }
+
+  // Queue after gestures with the same time, so arrival order is kept
+  vtkstd::vector<vtkRenciGesture>& queue = this->Internals->Queue;
+  queue.insert(vtkstd::upper_bound(queue.begin(), queue.end(), gesture), gesture);
+
+  this->ReportReceived();
 }
 
 //----------------------------------------------------------------------------
 void vtkRenciMultiTouch::ClearGesture() 
 {
-  this->Internals->GestureName = "";
-  this->Internals->TouchPoints.clear();
+  this->Internals->NumberOfGestures = 0;
+  this->Internals->CurrentGesture = -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::TrackTouches() 
+{
+  vtkRenciMultiTouchInternals* internals = this->Internals;
+
+  // Remove the touches that ended last update
+  for (int i = 0; i < internals->NumberOfTouches; )
+    {
+    if (internals->Touches[i].Phase == vtkRenciMultiTouch::TouchEnded)
+      {
+      internals->RemoveTouch(i);
+      }
+    else
+      {
+      internals->Touches[i].Phase = vtkRenciMultiTouch::TouchStationary;
+      i++;
+      }
+    }
+
+  internals->NumberOfMoved = 0;
+  internals->NumberOfBegan = 0;
+  internals->NumberOfEnded = 0;
+
+  // Without a gesture the touches are as they were
+  if (internals->NumberOfGestures == 0) return;
+
+  // Gesture times can be OSC timetags from the sender's clock, so 
+  // prediction goes by the local time touches were taken in
+  double now = vtkTimerLog::GetUniversalTime();
+
+  const vtkRenciGesture& gesture = internals->Gestures[internals->NumberOfGestures - 1];
+
+  unsigned char seen[vtkRenciMultiTouch::MaximumNumberOfTrackedTouches];
+  memset(seen, 0, sizeof(seen));
+
+  for (unsigned int i = 0; i < gesture.TouchPoints.size(); i++)
+    {
+    const TouchPoint& tp = gesture.TouchPoints[i];
+
+    unsigned int slot = internals->FindSlot(tp.Id);
+    int index = internals->Table[slot];
+
+    if (index < 0)
+      {
+      if (internals->NumberOfTouches == vtkRenciMultiTouch::MaximumNumberOfTrackedTouches) continue;
+
+      index = internals->NumberOfTouches++;
+      internals->Table[slot] = index;
+      seen[index] = 1;
+
+      TrackedTouch& touch = internals->Touches[index];
+      touch.Id = tp.Id;
+      touch.Location[0] = tp.Location[0];
+      touch.Location[1] = tp.Location[1];
+      touch.Velocity[0] = touch.Velocity[1] = 0.0;
+      touch.StartTime = touch.Time = gesture.Time;
+      touch.ReceiveTime = now;
+      touch.Phase = vtkRenciMultiTouch::TouchBegan;
+      touch.PredictedLocation[0] = tp.Location[0];
+      touch.PredictedLocation[1] = tp.Location[1];
+
+      internals->NumberOfBegan++;
+      continue;
+      }
+
+    seen[index] = 1;
+
+    TrackedTouch& touch = internals->Touches[index];
+    if (touch.Phase != vtkRenciMultiTouch::TouchStationary ||
+        (tp.Location[0] == touch.Location[0] && tp.Location[1] == touch.Location[1]))
+      {
+      continue;
+      }
+
+    double dt = gesture.Time - touch.Time;
+    for (int j = 0; j < 2; j++)
+      {
+      if (dt > 0.0)
+        {
+        double velocity = (tp.Location[j] - touch.Location[j]) / dt;
+        touch.Velocity[j] += VelocitySmoothing * (velocity - touch.Velocity[j]);
+        }
+      touch.Location[j] = tp.Location[j];
+      }
+    touch.Time = gesture.Time;
+    touch.ReceiveTime = now;
+    touch.Phase = vtkRenciMultiTouch::TouchMoved;
+
+    internals->Moved[internals->NumberOfMoved++] = index;
+    }
+
+  // Touches missing from the gesture have been lifted
+  for (int i = 0; i < internals->NumberOfTouches; i++)
+    {
+    if (!seen[i])
+      {
+      internals->Touches[i].Phase = vtkRenciMultiTouch::TouchEnded;
+      internals->NumberOfEnded++;
+      }
+    }
+
+  // Extrapolate the touches for the display
+  for (int i = 0; i < internals->NumberOfTouches; i++)
+    {
+    TrackedTouch& touch = internals->Touches[i];
+
+    double offset[2] = { 0.0, 0.0 };
+    if (this->PredictionHorizon > 0.0 && touch.Phase != vtkRenciMultiTouch::TouchEnded &&
+        now - touch.ReceiveTime <= 2.0 * this->PredictionHorizon)
+      {
+      offset[0] = touch.Velocity[0] * this->PredictionHorizon;
+      offset[1] = touch.Velocity[1] * this->PredictionHorizon;
+
+      double distance = sqrt(offset[0] * offset[0] + offset[1] * offset[1]);
+      if (distance > this->MaximumPredictionDistance)
+        {
+        offset[0] *= this->MaximumPredictionDistance / distance;
+        offset[1] *= this->MaximumPredictionDistance / distance;
+        }
+      }
+
+    for (int j = 0; j < 2; j++)
+      {
+      double predicted = touch.Location[j] + offset[j];
+      touch.PredictedDirection[j] = predicted - touch.PredictedLocation[j];
+      touch.PredictedLocation[j] = predicted;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkRenciMultiTouch::CheckConnection()
+{
+  if (this->SocketDescriptor == -1)
+    {
+    return this->GestureRecognizer && this->HostName == NULL ? 
+           vtkInteractionDevice::Connected : vtkInteractionDevice::Disconnected;
+    }
+
+  return vtkInteractionDevice::Connected;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouch::Disconnect()
+{
+  if (this->SocketDescriptor == -1) return;
+
+#ifdef WIN32
+  closesocket(this->SocketDescriptor);
+#endif
+  this->SocketDescriptor = -1;
 }
 
 //----------------------------------------------------------------------------
@@ -286,6 +787,7 @@ int vtkRenciMultiTouch::CreateSocket()
   if (this->SocketDescriptor == INVALID_SOCKET)
     {
     vtkErrorMacro(<<"Could not create socket!");
+    this->SocketDescriptor = -1;
     return -1;
     }
 
@@ -295,6 +797,7 @@ int vtkRenciMultiTouch::CreateSocket()
     {
     vtkErrorMacro(<<"Could not set non-blocking mode!");
     closesocket(this->SocketDescriptor);
+    this->SocketDescriptor = -1;
     return -1;
     }
 
@@ -309,6 +812,7 @@ int vtkRenciMultiTouch::CreateSocket()
     {
     vtkErrorMacro(<<"Could not bind name to socket!");
     closesocket(this->SocketDescriptor);
+    this->SocketDescriptor = -1;
     return -1;
     }
 #else
@@ -330,7 +834,7 @@ int vtkRenciMultiTouch::Receive(void* data, int length)
 }
 
 //----------------------------------------------------------------------------
-int vtkRenciMultiTouch::ReadInt(char** buffer)
+int vtkRenciMultiTouch::ReadInt(const char** buffer)
 {
   char intBuffer[4];
   memcpy(intBuffer, *buffer, 4);
@@ -341,7 +845,7 @@ int vtkRenciMultiTouch::ReadInt(char** buffer)
 }
 
 //----------------------------------------------------------------------------
-double vtkRenciMultiTouch::ReadDouble(char** buffer)
+double vtkRenciMultiTouch::ReadDouble(const char** buffer)
 {
   char doubleBuffer[8];
   memcpy(doubleBuffer, *buffer, 8);
@@ -374,17 +878,26 @@ void vtkRenciMultiTouch::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "HostName: " << this->HostName << "\n";
   os << indent << "Port: " << this->Port << "\n";
   os << indent << "SocketDescriptor: " << this->SocketDescriptor << "\n";
-  os << indent << "GestureName: " << this->Internals->GestureName << "\n";
+  os << indent << "MaximumDelay: " << this->MaximumDelay << "\n";
+  os << indent << "PredictionHorizon: " << this->PredictionHorizon << "\n";
+  os << indent << "MaximumPredictionDistance: " << this->MaximumPredictionDistance << "\n";
+  os << indent << "GestureRecognizer: " << this->GestureRecognizer << "\n";
+  os << indent << "NumberOfQueuedGestures: " << this->Internals->Queue.size() << "\n";
+  os << indent << "Gesture: " << vtkRenciMultiTouch::GetGestureName(this->GetGestureEventId()) << "\n";
+  os << indent << "GestureTime: " << this->GetGestureTime() << "\n";
+  os << indent << "NumberOfTrackedTouches: " << this->Internals->NumberOfTouches << "\n";
+  os << indent << "NumberOfMovedTouches: " << this->Internals->NumberOfMoved << "\n";
   os << indent << "TouchPoints:\n";
-  for (unsigned int i = 0; i < this->Internals->TouchPoints.size(); i++)
+  for (int i = 0; i < this->GetNumberOfTouchPoints(); i++)
     {
+    const TouchPoint& tp = this->GetTouchPoint(i);
     os << indent << indent << "TouchPoint " << i << "\n";
-    os << indent << indent << indent << "Id: " << this->Internals->TouchPoints[i].Id << "\n";
-    os << indent << indent << indent << "Location: (" << this->Internals->TouchPoints[i].Location[0]
-       << ", " << this->Internals->TouchPoints[i].Location[1] << ")\n";
-    os << indent << indent << indent << "Direction: (" << this->Internals->TouchPoints[i].Direction[0]
-       << ", " << this->Internals->TouchPoints[i].Direction[1] << ")\n";    
-    os << indent << indent << indent << "MoveLocation " << this->Internals->TouchPoints[i].MoveLocation << "\n";    
+    os << indent << indent << indent << "Id: " << tp.Id << "\n";
+    os << indent << indent << indent << "Location: (" << tp.Location[0]
+       << ", " << tp.Location[1] << ")\n";
+    os << indent << indent << indent << "Direction: (" << tp.Direction[0]
+       << ", " << tp.Direction[1] << ")\n";    
+    os << indent << indent << indent << "MoveLocation " << tp.MoveLocation << "\n";    
     }
   os << "\n";
 }
@@ -18,6 +18,23 @@
 // vtkRenciMultiTouch interfaces with multi-touch devices developed at
 // the Renaissance Computing Institute 
 // (http://vis.renci.org/multitouch/).  
+//
+// Gestures are normally classified by the multi-touch server.  With a 
+// vtkMultiTouchGestureRecognizer set, gestures are also recognized in 
+// process from raw touches fed to the recognizer, and no server is 
+// needed if the host name isn't set.
+//
+// Server packets can be OSC bundles holding several gestures.  Gestures 
+// are applied in timetag order once their time has come, and every 
+// gesture due in an update is dispatched in turn.  Bundles timetagged 
+// "immediately", and plain messages, apply as they are received.
+//
+// Touches are also tracked across updates by id.  The touch points of 
+// the last gesture in an update are the touches down, so touches begin, 
+// move and end as they appear in, change in and drop out of gestures, 
+// and updates without gestures leave them as they were.  TouchBeginEvent,
+// TouchMoveEvent and TouchEndEvent are invoked once per update when any 
+// touch changes phase, before and after the gesture events.
 
 // .SECTION see also
 // vtkInteractionDeviceManager vtkDeviceInteractorStyle
@@ -45,6 +62,22 @@ struct TouchPoint
   int MoveLocation;
 };
 
+// Structure defining a touch tracked across updates
+struct TrackedTouch
+{
+  int Id;
+  double Location[2];
+  double Velocity[2];
+  double StartTime;
+  double Time;
+  double ReceiveTime;
+  int Phase;
+  double PredictedLocation[2];
+  double PredictedDirection[2];
+};
+
+class vtkMultiTouchGestureRecognizer;
+
 // Holds vtkstd member variables, which must be hidden
 class vtkRenciMultiTouchInternals;
 
@@ -64,9 +97,19 @@ public:
   virtual void Update();
 
   // Description:
-  // Invoke events for observers to listen for
+  // Receive waiting packets, queueing their gestures for the next Update()
+  virtual void Poll();
+
+  // Description:
+  // Invoke the touch events, and an event for each gesture due this 
+  // update
   virtual void InvokeInteractionEvent();
 
+  // Description:
+  // Write/read the state received in the last Update()
+  virtual void WriteState(vtkDeviceStateStream*);
+  virtual void ReadState(vtkDeviceStateStream*);
+
   // Description:
   // Set socket information.  Must be set before Initialize().
   vtkSetStringMacro(HostName);
@@ -77,6 +120,80 @@ public:
   int GetNumberOfTouchPoints();
   const TouchPoint& GetTouchPoint(int which);
 
+  // Description:
+  // Get the event id of the current gesture, or 0 if there is none
+  int GetGestureEventId();
+
+  // Description:
+  // Get the touches tracked across updates, including those that ended 
+  // this update.  Velocity is in normalized units per second, smoothed 
+  // over the touch's recent moves, and Time is the time of its last move.
+  // ReceiveTime is the local time the last move was taken in, as Time 
+  // can come from the sender's clock.
+  // PredictedLocation is the location extrapolated PredictionHorizon 
+  // ahead, and PredictedDirection its motion since the last update with 
+  // a gesture.
+  int GetNumberOfTrackedTouches();
+  const TrackedTouch& GetTrackedTouch(int which);
+
+  // Description:
+  // Find a tracked touch by id.  Returns NULL if it isn't down, 
+  // including touches that ended this update.
+  const TrackedTouch* FindTrackedTouch(int id);
+
+  // Description:
+  // Get the touches that moved since the last update
+  int GetNumberOfMovedTouches();
+  const TrackedTouch& GetMovedTouch(int which);
+
+  // Description:
+  // Get a touch point of the current gesture with its location and 
+  // direction predicted by the touch tracking.  With several gestures in 
+  // an update, the predicted motion is reported with the last, and the 
+  // others have no direction.  Returns 0, leaving the touch point as 
+  // received, if prediction is off or the touch isn't tracked.
+  int GetPredictedTouchPoint(int which, TouchPoint& touchPoint);
+
+  // Description:
+  // Time in seconds to extrapolate touches ahead, to hide the latency 
+  // from the touch hardware to the display.  Touches are extrapolated at
+  // their smoothed velocity, unless they haven't moved for twice the 
+  // horizon.  0, the default, turns prediction off.
+  vtkSetClampMacro(PredictionHorizon,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(PredictionHorizon,double);
+
+  // Description:
+  // The largest distance, in normalized units, a predicted location can
+  // be from the received one.  This bounds the overshoot when a touch 
+  // stops or lifts suddenly.  The default is 0.05.
+  vtkSetClampMacro(MaximumPredictionDistance,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MaximumPredictionDistance,double);
+
+  // Description:
+  // Get the time of the current gesture in seconds since 1970, from its
+  // OSC timetag, or the time it was received if it has none
+  double GetGestureTime();
+
+  // Description:
+  // Get the number of gestures timetagged for later updates
+  int GetNumberOfQueuedGestures();
+
+  // Description:
+  // Gestures timetagged further ahead than this, in seconds, are taken to
+  // come from a sender with a skewed clock and applied when received.  
+  // The default is 1 second.
+  vtkSetClampMacro(MaximumDelay,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MaximumDelay,double);
+
+  // Description:
+  // Get the server's name for a gesture event id, e.g. "one_drag"
+  static const char* GetGestureName(int eventId);
+
+  // Description:
+  // Set/get a recognizer for classifying raw touches in process
+  void SetGestureRecognizer(vtkMultiTouchGestureRecognizer*);
+  vtkGetObjectMacro(GestureRecognizer,vtkMultiTouchGestureRecognizer);
+
   // Enumeration for multi-touch events
   //BTX
   enum RenciMultiTouchEventIds {
@@ -99,8 +216,21 @@ public:
       RotateXEvent,
       RotateYEvent,
       RotateZEvent,
-      ReleaseEvent
+      ReleaseEvent,
+      TouchBeginEvent,
+      TouchMoveEvent,
+      TouchEndEvent
+  };
+
+  // Phases of tracked touches
+  enum TouchPhases {
+      TouchBegan,
+      TouchMoved,
+      TouchStationary,
+      TouchEnded
   };
+
+  enum { MaximumNumberOfTrackedTouches = 64 };
   //ETX
 
 protected:
@@ -110,24 +240,49 @@ protected:
   // The socket being read
   char* HostName;
   int Port;
-  int SocketDescriptor;
+  int SocketDescriptor;  // -1 when closed
+
+  double MaximumDelay;
+
+  double PredictionHorizon;
+  double MaximumPredictionDistance;
+
+  vtkMultiTouchGestureRecognizer* GestureRecognizer;
 
   vtkRenciMultiTouchInternals* Internals;
 
   // Description:
-  // Parse the buffer
-  void ParseBuffer(char* buffer, int numBytes);
+  // Receive and parse a gesture from the server
+  virtual void ReceiveGesture();
+
+  // Description:
+  // Parse an OSC packet, which can be a bundle or a message, queueing its
+  // gestures.  time is used for gestures without a timetag.
+  void ParsePacket(const char* data, int size, double time);
+  void ParseMessage(const char* data, int size, double time);
 
   // Description:
   // Clear the current gesture
   void ClearGesture();
 
+  // Description:
+  // Update the tracked touches from the last gesture of this update
+  void TrackTouches();
+
+  // Description:
+  // Connected once the socket is bound
+  virtual int CheckConnection();
+
+  // Description:
+  // Close the socket
+  virtual void Disconnect();
+
   // Description:
   // Socket code.  vtkSocket currently uses TCP, so leave this code in here for now.
   int CreateSocket();
   int Receive(void* data, int length);
-  int ReadInt(char** buffer);
-  double ReadDouble(char** buffer);
+  int ReadInt(const char** buffer);
+  double ReadDouble(const char** buffer);
   double Ntohd(double d);
 
 private:
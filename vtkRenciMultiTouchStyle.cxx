@@ -16,15 +16,50 @@
 
 #include "vtkRenciMultiTouchStyle.h"
 
-#include "vtkCallbackCommand.h"
-
 #include "vtkRenciMultiTouch.h"
 
 vtkCxxRevisionMacro(vtkRenciMultiTouchStyle, "$Revision: 1.0 $");
 
+// Handlers indexed by event id, in the order of RenciMultiTouchEventIds
+const vtkRenciMultiTouchStyle::EventHandler vtkRenciMultiTouchStyle::EventHandlers[] =
+{
+  &vtkRenciMultiTouchStyle::OnOneTouch,
+  &vtkRenciMultiTouchStyle::OnOneDrag,
+  &vtkRenciMultiTouchStyle::OnTwoTouch,
+  &vtkRenciMultiTouchStyle::OnTwoDrag,
+  &vtkRenciMultiTouchStyle::OnThreeTouch,
+  &vtkRenciMultiTouchStyle::OnThreeDrag,
+  &vtkRenciMultiTouchStyle::OnFourTouch,
+  &vtkRenciMultiTouchStyle::OnFourDrag,
+  &vtkRenciMultiTouchStyle::OnFiveTouch,
+  &vtkRenciMultiTouchStyle::OnFiveDrag,
+  &vtkRenciMultiTouchStyle::OnSixTouch,
+  &vtkRenciMultiTouchStyle::OnSixDrag,
+  &vtkRenciMultiTouchStyle::OnZoom,
+  &vtkRenciMultiTouchStyle::OnTranslateX,
+  &vtkRenciMultiTouchStyle::OnTranslateY,
+  &vtkRenciMultiTouchStyle::OnTranslateZ,
+  &vtkRenciMultiTouchStyle::OnRotateX,
+  &vtkRenciMultiTouchStyle::OnRotateY,
+  &vtkRenciMultiTouchStyle::OnRotateZ,
+  &vtkRenciMultiTouchStyle::OnRelease,
+  &vtkRenciMultiTouchStyle::OnTouchBegin,
+  &vtkRenciMultiTouchStyle::OnTouchMove,
+  &vtkRenciMultiTouchStyle::OnTouchEnd
+};
+
+static const unsigned long NumberOfEventHandlers = 
+  vtkRenciMultiTouch::TouchEndEvent - vtkRenciMultiTouch::OneTouchEvent + 1;
+
 //----------------------------------------------------------------------------
 vtkRenciMultiTouchStyle::vtkRenciMultiTouchStyle() 
 { 
+  // All events
+  this->EventMask = 0;
+  for (unsigned long i = 0; i < NumberOfEventHandlers; i++)
+    {
+    this->EventMask |= vtkInteractionDevice::EventBit(vtkRenciMultiTouch::OneTouchEvent + i);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -32,40 +67,36 @@ vtkRenciMultiTouchStyle::~vtkRenciMultiTouchStyle()
 {
 }
 
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyle::OnEvent(vtkObject* caller, unsigned long eid, void*) 
+{
+  this->HandleEvent(static_cast<vtkRenciMultiTouch*>(caller), eid);
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyle::OnDeviceEvent(vtkInteractionDevice* device, unsigned long eid) 
+{
+  this->HandleEvent(static_cast<vtkRenciMultiTouch*>(device), eid);
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyle::HandleEvent(vtkRenciMultiTouch* multiTouch, unsigned long eid) 
+{
+  // Wraps around for ids below OneTouchEvent
+  unsigned long index = eid - vtkRenciMultiTouch::OneTouchEvent;
+
+  if (index < NumberOfEventHandlers)
+    {
+    (this->*EventHandlers[index])(multiTouch);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkRenciMultiTouchStyle::SetMultiTouch(vtkRenciMultiTouch* multiTouch)
 {  
   if (multiTouch != NULL) 
     {
-    // Touch and drag events
-    multiTouch->AddObserver(vtkRenciMultiTouch::OneTouchEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::OneDragEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::TwoTouchEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::TwoDragEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::ThreeTouchEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::ThreeDragEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::FourTouchEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::FourDragEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::FiveTouchEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::FiveDragEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::SixTouchEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::SixDragEvent, this->DeviceCallback);
-
-    // Zoom event
-    multiTouch->AddObserver(vtkRenciMultiTouch::ZoomEvent, this->DeviceCallback);
-
-    // Translate events
-    multiTouch->AddObserver(vtkRenciMultiTouch::TranslateYEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::TranslateYEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::TranslateZEvent, this->DeviceCallback);
-
-    // Rotate events
-    multiTouch->AddObserver(vtkRenciMultiTouch::RotateXEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::RotateYEvent, this->DeviceCallback);
-    multiTouch->AddObserver(vtkRenciMultiTouch::RotateZEvent, this->DeviceCallback);
-
-    // Release event
-    multiTouch->AddObserver(vtkRenciMultiTouch::ReleaseEvent, this->DeviceCallback);
+    multiTouch->AddDeviceInteractorStyle(this, this->EventMask);
     }
 }
 
@@ -73,4 +104,6 @@ void vtkRenciMultiTouchStyle::SetMultiTouch(vtkRenciMultiTouch* multiTouch)
 void vtkRenciMultiTouchStyle::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "EventMask: " << this->EventMask << "\n";
 }
\ No newline at end of file
@@ -37,6 +37,11 @@ public:
   vtkTypeRevisionMacro(vtkRenciMultiTouchStyle,vtkDeviceInteractorStyle);
   void PrintSelf(ostream&, vtkIndent); 
 
+  // Description:
+  // Perform interaction based on an event
+  virtual void OnEvent(vtkObject* caller, unsigned long eid, void* callData);
+  virtual void OnDeviceEvent(vtkInteractionDevice* device, unsigned long eid);
+
   // Description:
   // Set the tracker receiving events from
   void SetMultiTouch(vtkRenciMultiTouch*);
@@ -45,6 +50,21 @@ protected:
   vtkRenciMultiTouchStyle();
   ~vtkRenciMultiTouchStyle();
 
+  // Description:
+  // The events to subscribe to, as a bitwise OR of 
+  // vtkInteractionDevice::EventBit() values.  Subclasses should set this 
+  // to the events they override handlers for.
+  unsigned long EventMask;
+
+  // Description:
+  // Call the handler for an event via the handler table
+  void HandleEvent(vtkRenciMultiTouch* multiTouch, unsigned long eid);
+
+  //BTX
+  typedef void (vtkRenciMultiTouchStyle::*EventHandler)(vtkRenciMultiTouch*);
+  static const EventHandler EventHandlers[];
+  //ETX
+
   // Description:
   // These methods should be overloaded as needed in derived classes
   virtual void OnOneTouch(vtkRenciMultiTouch*) {}
@@ -67,6 +87,9 @@ protected:
   virtual void OnRotateY(vtkRenciMultiTouch*) {}
   virtual void OnRotateZ(vtkRenciMultiTouch*) {}
   virtual void OnRelease(vtkRenciMultiTouch*) {}
+  virtual void OnTouchBegin(vtkRenciMultiTouch*) {}
+  virtual void OnTouchMove(vtkRenciMultiTouch*) {}
+  virtual void OnTouchEnd(vtkRenciMultiTouch*) {}
 
 private:
   vtkRenciMultiTouchStyle(const vtkRenciMultiTouchStyle&);  // Not implemented.
@@ -17,11 +17,13 @@
 #include "vtkRenciMultiTouchStyleCamera.h"
 
 #include "vtkCamera.h"
-#include "vtkInteractorObserver.h"
+#include "vtkDeviceInertia.h"
+#include "vtkDeviceViewTransform.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkRenciMultiTouch.h"
 #include "vtkRenderer.h"
+#include "vtkTimerLog.h"
 #include "vtkstd/string"
 #include "vtkstd/vector"
 
@@ -31,62 +33,35 @@ vtkCxxRevisionMacro(vtkRenciMultiTouchStyleCamera, "$Revision: 1.0 $");
 //----------------------------------------------------------------------------
 vtkRenciMultiTouchStyleCamera::vtkRenciMultiTouchStyleCamera() 
 { 
+  this->EventMask = vtkInteractionDevice::EventBit(vtkRenciMultiTouch::OneDragEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::ZoomEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::TranslateXEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::TranslateYEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::RotateXEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::RotateYEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::RotateZEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::ReleaseEvent) |
+                    vtkInteractionDevice::EventBit(vtkRenciMultiTouch::TouchBeginEvent);
+
+  // Speeds in degrees and translate units per second
+  this->RotateInertia = vtkDeviceInertia::New();
+  this->RotateInertia->SetMinimumSpeed(1.0);
+  this->TranslateInertia = vtkDeviceInertia::New();
+  this->TranslateInertia->SetMinimumSpeed(1.0);
+
+  this->TranslateLocation[0] = this->TranslateLocation[1] = 0.0;
 }
 
 //----------------------------------------------------------------------------
 vtkRenciMultiTouchStyleCamera::~vtkRenciMultiTouchStyleCamera() 
 {
-}
-
-//----------------------------------------------------------------------------
-void vtkRenciMultiTouchStyleCamera::OnEvent(vtkObject* caller, unsigned long eid, void* calldata) 
-{
-  vtkRenciMultiTouch* multiTouch = static_cast<vtkRenciMultiTouch*>(caller);
-
-  switch(eid)
-    {
-    // One Drag
-    case vtkRenciMultiTouch::OneDragEvent:
-      this->OnOneDrag(multiTouch);
-      break;
-
-    // Zoom
-    case vtkRenciMultiTouch::ZoomEvent:
-      this->OnZoom(multiTouch);
-      break;
-
-    // Translate X
-    case vtkRenciMultiTouch::TranslateXEvent:
-      this->OnTranslateX(multiTouch);
-      break;
-
-    // Translate Y
-    case vtkRenciMultiTouch::TranslateYEvent:
-      this->OnTranslateY(multiTouch);
-      break;
-
-    // Rotate X
-    case vtkRenciMultiTouch::RotateXEvent:
-      this->OnRotateX(multiTouch);
-      break;
-
-    // Rotate Y
-    case vtkRenciMultiTouch::RotateYEvent:
-      this->OnRotateY(multiTouch);
-      break;
-
-    // Rotate Z
-    case vtkRenciMultiTouch::RotateZEvent:
-      this->OnRotateZ(multiTouch);
-      break;
-    }
+  this->RotateInertia->Delete();
+  this->TranslateInertia->Delete();
 }
 
 //----------------------------------------------------------------------------
 void vtkRenciMultiTouchStyleCamera::OnOneDrag(vtkRenciMultiTouch* multiTouch)
 {
-  vtkCamera* camera = this->Renderer->GetActiveCamera();
-
   int numTouches = multiTouch->GetNumberOfTouchPoints();
   if (numTouches < 1) return;
 
@@ -94,7 +69,7 @@ void vtkRenciMultiTouchStyleCamera::OnOneDrag(vtkRenciMultiTouch* multiTouch)
   touches.resize(numTouches);
   for (int i = 0; i < numTouches; i++) 
     {
-    touches[i] = multiTouch->GetTouchPoint(i);
+    multiTouch->GetPredictedTouchPoint(i, touches[i]);
     }
 
   // XXX: Magic number
@@ -102,12 +77,11 @@ void vtkRenciMultiTouchStyleCamera::OnOneDrag(vtkRenciMultiTouch* multiTouch)
   double dx = touches[0].Direction[0] * rotateSensitivity;
   double dy = touches[0].Direction[1] * rotateSensitivity; 
 
-  camera->Azimuth(-dx);
-  camera->Elevation(dy);
-  camera->OrthogonalizeViewUp();
+  this->Rotate(-dx, dy);
 
-  this->Renderer->ResetCameraClippingRange();
-  // Render() will be called in the interactor
+  double motion[3] = { -dx, dy, 0.0 };
+  this->RotateInertia->AddMotion(motion, vtkTimerLog::GetUniversalTime());
+  this->TranslateInertia->Stop();
 }
 
 //----------------------------------------------------------------------------
@@ -122,7 +96,7 @@ void vtkRenciMultiTouchStyleCamera::OnZoom(vtkRenciMultiTouch* multiTouch)
   touches.resize(numTouches);
   for (int i = 0; i < numTouches; i++) 
     {
-    touches[i] = multiTouch->GetTouchPoint(i);
+    multiTouch->GetPredictedTouchPoint(i, touches[i]);
     }
 
   double zoomAmount = sqrt(touches[0].Direction[0] * touches[0].Direction[0] +
@@ -162,21 +136,20 @@ void vtkRenciMultiTouchStyleCamera::OnZoom(vtkRenciMultiTouch* multiTouch)
     }
 
   this->Renderer->ResetCameraClippingRange();
+  this->Interact();
   // Render() will be called in the interactor
 }
 
 //----------------------------------------------------------------------------
 void vtkRenciMultiTouchStyleCamera::OnTranslateX(vtkRenciMultiTouch* multiTouch)
 {
-  vtkCamera* camera = this->Renderer->GetActiveCamera();
-
   int numTouches = multiTouch->GetNumberOfTouchPoints();
 
   vtkstd::vector<TouchPoint> touches;
   touches.resize(numTouches);
   for (int i = 0; i < numTouches; i++) 
     {
-    touches[i] = multiTouch->GetTouchPoint(i);
+    multiTouch->GetPredictedTouchPoint(i, touches[i]);
     }
 
   int i;
@@ -193,53 +166,25 @@ void vtkRenciMultiTouchStyleCamera::OnTranslateX(vtkRenciMultiTouch* multiTouch)
   double dx = touches[i].Direction[1] * translateSensitivity;
   double dy = 0.0; 
 
-  double viewFocus[4], focalDepth, viewPoint[3];
-  double newPickPoint[4], oldPickPoint[4], motionVector[3];
-
-  camera->GetFocalPoint(viewFocus);
-  vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer, 
-                                               viewFocus[0], viewFocus[1], viewFocus[2], 
-                                               viewFocus);
-  focalDepth = viewFocus[2];
+  this->Translate(x, y, dx, dy);
 
-  vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer, 
-                                               x, y, focalDepth, 
-                                               newPickPoint);
-
-  vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer,
-                                               x + dx, y + dy, focalDepth, 
-                                               oldPickPoint);
-  
-  // Camera motion is reversed
-  motionVector[0] = oldPickPoint[0] - newPickPoint[0];
-  motionVector[1] = oldPickPoint[1] - newPickPoint[1];
-  motionVector[2] = oldPickPoint[2] - newPickPoint[2];
-  
-  camera->GetFocalPoint(viewFocus);
-  camera->GetPosition(viewPoint);
-  camera->SetFocalPoint(motionVector[0] + viewFocus[0],
-                        motionVector[1] + viewFocus[1],
-                        motionVector[2] + viewFocus[2]);
-
-  camera->SetPosition(motionVector[0] + viewPoint[0],
-                      motionVector[1] + viewPoint[1],
-                      motionVector[2] + viewPoint[2]);
-      
-  // Render() will be called in the interactor
+  double motion[3] = { dx, dy, 0.0 };
+  this->TranslateInertia->AddMotion(motion, vtkTimerLog::GetUniversalTime());
+  this->TranslateLocation[0] = x;
+  this->TranslateLocation[1] = y;
+  this->RotateInertia->Stop();
 }
 
 //----------------------------------------------------------------------------
 void vtkRenciMultiTouchStyleCamera::OnTranslateY(vtkRenciMultiTouch* multiTouch)
 {
-  vtkCamera* camera = this->Renderer->GetActiveCamera();
-
   int numTouches = multiTouch->GetNumberOfTouchPoints();
 
   vtkstd::vector<TouchPoint> touches;
   touches.resize(numTouches);
   for (int i = 0; i < numTouches; i++) 
     {
-    touches[i] = multiTouch->GetTouchPoint(i);
+    multiTouch->GetPredictedTouchPoint(i, touches[i]);
     }
 
   int i;
@@ -255,39 +200,13 @@ void vtkRenciMultiTouchStyleCamera::OnTranslateY(vtkRenciMultiTouch* multiTouch)
   double dx = 0.0;
   double dy = touches[i].Direction[1] * translateScale; 
 
-  double viewFocus[4], focalDepth, viewPoint[3];
-  double newPickPoint[4], oldPickPoint[4], motionVector[3];
-
-  camera->GetFocalPoint(viewFocus);
-  vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer, 
-                                               viewFocus[0], viewFocus[1], viewFocus[2], 
-                                               viewFocus);
-  focalDepth = viewFocus[2];
-
-  vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer, 
-                                               x, y, focalDepth, 
-                                               newPickPoint);
-
-  vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer, 
-                                               x + dx, y + dy, focalDepth, 
-                                               oldPickPoint);
-  
-  // Camera motion is reversed
-  motionVector[0] = oldPickPoint[0] - newPickPoint[0];
-  motionVector[1] = oldPickPoint[1] - newPickPoint[1];
-  motionVector[2] = oldPickPoint[2] - newPickPoint[2];
-  
-  camera->GetFocalPoint(viewFocus);
-  camera->GetPosition(viewPoint);
-  camera->SetFocalPoint(motionVector[0] + viewFocus[0],
-                        motionVector[1] + viewFocus[1],
-                        motionVector[2] + viewFocus[2]);
+  this->Translate(x, y, dx, dy);
 
-  camera->SetPosition(motionVector[0] + viewPoint[0],
-                      motionVector[1] + viewPoint[1],
-                      motionVector[2] + viewPoint[2]);
-      
-  // Render() will be called in the interactor
+  double motion[3] = { dx, dy, 0.0 };
+  this->TranslateInertia->AddMotion(motion, vtkTimerLog::GetUniversalTime());
+  this->TranslateLocation[0] = x;
+  this->TranslateLocation[1] = y;
+  this->RotateInertia->Stop();
 }
 
 //----------------------------------------------------------------------------
@@ -301,7 +220,7 @@ void vtkRenciMultiTouchStyleCamera::OnRotateX(vtkRenciMultiTouch* multiTouch)
   touches.resize(numTouches);
   for (int i = 0; i < numTouches; i++) 
     {
-    touches[i] = multiTouch->GetTouchPoint(i);
+    multiTouch->GetPredictedTouchPoint(i, touches[i]);
     }
 
   int i;
@@ -318,6 +237,7 @@ void vtkRenciMultiTouchStyleCamera::OnRotateX(vtkRenciMultiTouch* multiTouch)
   camera->OrthogonalizeViewUp();
 
   this->Renderer->ResetCameraClippingRange();
+  this->Interact();
   // Render() will be called in the interactor
 }
 
@@ -332,7 +252,7 @@ void vtkRenciMultiTouchStyleCamera::OnRotateY(vtkRenciMultiTouch* multiTouch)
   touches.resize(numTouches);
   for (int i = 0; i < numTouches; i++) 
     {
-    touches[i] = multiTouch->GetTouchPoint(i);
+    multiTouch->GetPredictedTouchPoint(i, touches[i]);
     }
 
   int i;
@@ -349,6 +269,7 @@ void vtkRenciMultiTouchStyleCamera::OnRotateY(vtkRenciMultiTouch* multiTouch)
   camera->OrthogonalizeViewUp();
 
   this->Renderer->ResetCameraClippingRange();
+  this->Interact();
   // Render() will be called in the interactor
 }
 
@@ -363,7 +284,7 @@ void vtkRenciMultiTouchStyleCamera::OnRotateZ(vtkRenciMultiTouch* multiTouch)
   touches.resize(numTouches);
   for (int i = 0; i < numTouches; i++) 
     {
-    touches[i] = multiTouch->GetTouchPoint(i);
+    multiTouch->GetPredictedTouchPoint(i, touches[i]);
     }
 
   int i;
@@ -380,6 +301,93 @@ void vtkRenciMultiTouchStyleCamera::OnRotateZ(vtkRenciMultiTouch* multiTouch)
   camera->OrthogonalizeViewUp();
 
   this->Renderer->ResetCameraClippingRange();
+  this->Interact();
+  // Render() will be called in the interactor
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyleCamera::OnRelease(vtkRenciMultiTouch*)
+{
+  // Flicks coast on
+  double time = vtkTimerLog::GetUniversalTime();
+  this->RotateInertia->Release(time);
+  this->TranslateInertia->Release(time);
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyleCamera::OnTouchBegin(vtkRenciMultiTouch*)
+{
+  // A new touch catches the camera
+  this->RotateInertia->Stop();
+  this->TranslateInertia->Stop();
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyleCamera::EndFrame()
+{
+  double time = vtkTimerLog::GetUniversalTime();
+  double motion[3];
+
+  if (this->RotateInertia->Advance(time, motion))
+    {
+    this->Rotate(motion[0], motion[1]);
+    }
+
+  if (this->TranslateInertia->Advance(time, motion))
+    {
+    this->Translate(this->TranslateLocation[0], this->TranslateLocation[1], motion[0], motion[1]);
+    }
+
+  this->Superclass::EndFrame();
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyleCamera::Rotate(double azimuth, double elevation)
+{
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+
+  camera->Azimuth(azimuth);
+  camera->Elevation(elevation);
+  camera->OrthogonalizeViewUp();
+
+  this->Renderer->ResetCameraClippingRange();
+  this->Interact();
+  // Render() will be called in the interactor
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciMultiTouchStyleCamera::Translate(double x, double y, double dx, double dy)
+{
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+
+  vtkDeviceViewTransform* view = this->GetViewTransform();
+  double viewFocus[4], focalDepth, viewPoint[3];
+  double newPickPoint[4], oldPickPoint[4], motionVector[3];
+
+  camera->GetFocalPoint(viewFocus);
+  view->WorldToDisplay(viewFocus[0], viewFocus[1], viewFocus[2], viewFocus);
+  focalDepth = viewFocus[2];
+
+  view->WorldToDisplay(x, y, focalDepth, newPickPoint);
+
+  view->WorldToDisplay(x + dx, y + dy, focalDepth, oldPickPoint);
+  
+  // Camera motion is reversed
+  motionVector[0] = oldPickPoint[0] - newPickPoint[0];
+  motionVector[1] = oldPickPoint[1] - newPickPoint[1];
+  motionVector[2] = oldPickPoint[2] - newPickPoint[2];
+  
+  camera->GetFocalPoint(viewFocus);
+  camera->GetPosition(viewPoint);
+  camera->SetFocalPoint(motionVector[0] + viewFocus[0],
+                        motionVector[1] + viewFocus[1],
+                        motionVector[2] + viewFocus[2]);
+
+  camera->SetPosition(motionVector[0] + viewPoint[0],
+                      motionVector[1] + viewPoint[1],
+                      motionVector[2] + viewPoint[2]);
+
+  this->Interact();
   // Render() will be called in the interactor
 }
 
@@ -387,4 +395,9 @@ void vtkRenciMultiTouchStyleCamera::OnRotateZ(vtkRenciMultiTouch* multiTouch)
 void vtkRenciMultiTouchStyleCamera::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "RotateInertia:\n";
+  this->RotateInertia->PrintSelf(os,indent.GetNextIndent());
+  os << indent << "TranslateInertia:\n";
+  this->TranslateInertia->PrintSelf(os,indent.GetNextIndent());
 }
\ No newline at end of file
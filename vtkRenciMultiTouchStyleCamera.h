@@ -18,6 +18,14 @@
 // vtkRenciMultiTouchStyleCamera moves the camera based on events 
 // generated by multi-touch devices developed at Renci
 // (http://vis.renci.org/multitouch/).
+//
+// Touch points are read with vtkRenciMultiTouch::GetPredictedTouchPoint(),
+// so the camera follows the predicted touches when the device has a 
+// PredictionHorizon set.
+//
+// One finger drags and translates coast on when the touches are lifted 
+// while moving, slowing down with the damping of RotateInertia and 
+// TranslateInertia.  A new touch stops them.
 
 // .SECTION see also
 // vtkDeviceInteractor vtkInteractionDevice
@@ -29,6 +37,8 @@
 
 #include "vtkRenciMultiTouchStyle.h"
 
+class vtkDeviceInertia;
+
 class VTK_INTERACTIONDEVICE_EXPORT vtkRenciMultiTouchStyleCamera : public vtkRenciMultiTouchStyle
 {
 public:
@@ -37,8 +47,13 @@ public:
   void PrintSelf(ostream&, vtkIndent); 
 
   // Description:
-  // Perform interaction based on an event
-  virtual void OnEvent(vtkObject* caller, unsigned long eid, void* callData);
+  // Get the inertia of one finger drags, in degrees, and of translates
+  vtkGetObjectMacro(RotateInertia,vtkDeviceInertia);
+  vtkGetObjectMacro(TranslateInertia,vtkDeviceInertia);
+
+  // Description:
+  // Coast the camera
+  virtual void EndFrame();
 
 protected:
   vtkRenciMultiTouchStyleCamera();
@@ -51,6 +66,19 @@ protected:
   virtual void OnRotateX(vtkRenciMultiTouch*);
   virtual void OnRotateY(vtkRenciMultiTouch*);
   virtual void OnRotateZ(vtkRenciMultiTouch*);
+  virtual void OnRelease(vtkRenciMultiTouch*);
+  virtual void OnTouchBegin(vtkRenciMultiTouch*);
+
+  vtkDeviceInertia* RotateInertia;
+  vtkDeviceInertia* TranslateInertia;
+
+  // Touch location of the last translate, for coasting
+  double TranslateLocation[2];
+
+  // Description:
+  // Move the camera
+  void Rotate(double azimuth, double elevation);
+  void Translate(double x, double y, double dx, double dy);
 
 private:
   vtkRenciMultiTouchStyleCamera(const vtkRenciMultiTouchStyleCamera&);  // Not implemented.
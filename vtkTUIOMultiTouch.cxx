@@ -0,0 +1,570 @@
+/*=========================================================================
+
+  Name:        vtkTUIOMultiTouch.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+#include "vtkTUIOMultiTouch.h"
+
+#include "vtkMultiTouchGestureRecognizer.h"
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+
+#include <string.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// Largest UDP payload
+#define VTK_TUIO_MAX_PACKET 65507
+
+// Most alive ids and set messages kept per frame.  Larger than the number
+// of cursors tracked, so tracked cursors late in a long alive message 
+// aren't lifted.
+#define VTK_TUIO_MAX_FRAME 256
+
+// A cursor or object set message, waiting for its frame's fseq
+struct vtkTUIOSet
+{
+  int SessionId;
+  int ClassId;
+  double Location[2];
+  double Angle;
+  double Velocity[2];
+  double Acceleration;
+};
+
+// Alive ids and set messages of a profile, waiting for the fseq
+struct vtkTUIOFrame
+{
+  int Alive[VTK_TUIO_MAX_FRAME];
+  int NumberOfAlive;
+  int HasAlive;
+
+  vtkTUIOSet Sets[VTK_TUIO_MAX_FRAME];
+  int NumberOfSets;
+
+  int LastFrame;
+
+  void Clear()
+    {
+    this->NumberOfAlive = 0;
+    this->HasAlive = 0;
+    this->NumberOfSets = 0;
+    }
+
+  int IsAlive(int sessionId)
+    {
+    for (int i = 0; i < this->NumberOfAlive; i++)
+      {
+      if (this->Alive[i] == sessionId) return 1;
+      }
+    return 0;
+    }
+};
+
+class vtkTUIOMultiTouchInternals
+{
+public:
+  char Buffer[VTK_TUIO_MAX_PACKET];
+
+  vtkTUIOFrame CursorFrame;
+  vtkTUIOFrame ObjectFrame;
+
+  // Cursors and objects on the surface, packed at the front of the tables
+  TouchPoint Cursors[vtkTUIOMultiTouch::MaximumNumberOfCursors];
+  int NumberOfCursors;
+
+  TangibleObject Objects[vtkTUIOMultiTouch::MaximumNumberOfObjects];
+  int NumberOfObjects;
+
+  // Time the current packet was received
+  double Time;
+};
+
+// OSC helpers.  OSC values are big-endian and padded to 4 bytes.  Each 
+// returns 0 if the value runs past the end of the data.
+static int ReadOSCInt(const char*& data, const char* end, int& value)
+{
+  if (end - data < 4) return 0;
+
+  const unsigned char* b = reinterpret_cast<const unsigned char*>(data);
+  value = static_cast<int>((static_cast<unsigned int>(b[0]) << 24) | (b[1] << 16) | (b[2] << 8) | b[3]);
+  data += 4;
+
+  return 1;
+}
+
+static int ReadOSCFloat(const char*& data, const char* end, double& value)
+{
+  int bits;
+  if (!ReadOSCInt(data, end, bits)) return 0;
+
+  float f;
+  memcpy(&f, &bits, sizeof(float));
+  value = f;
+
+  return 1;
+}
+
+static int ReadOSCString(const char*& data, const char* end, const char*& value)
+{
+  const char* terminator = static_cast<const char*>(memchr(data, '\0', end - data));
+  if (terminator == NULL) return 0;
+
+  value = data;
+
+  // Skip the terminator and padding
+  int length = static_cast<int>(terminator - data) + 1;
+  data += (length + 3) & ~3;
+  if (data > end) data = end;
+
+  return 1;
+}
+
+// Skip an argument of a type not used by TUIO
+static int SkipOSCArgument(const char*& data, const char* end, char type)
+{
+  int i;
+  const char* s;
+  switch (type)
+    {
+    case 'i': case 'f': case 'c': case 'r': case 'm':
+      return ReadOSCInt(data, end, i);
+    case 'h': case 't': case 'd':
+      if (end - data < 8) return 0;
+      data += 8;
+      return 1;
+    case 's': case 'S':
+      return ReadOSCString(data, end, s);
+    case 'b':
+      if (!ReadOSCInt(data, end, i) || i < 0 || end - data < i) return 0;
+      data += (i + 3) & ~3;
+      if (data > end) data = end;
+      return 1;
+    default:
+      // T, F, N and I have no data
+      return 1;
+    }
+}
+
+vtkCxxRevisionMacro(vtkTUIOMultiTouch, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkTUIOMultiTouch);
+
+//----------------------------------------------------------------------------
+vtkTUIOMultiTouch::vtkTUIOMultiTouch() 
+{
+  this->TUIOInternals = new vtkTUIOMultiTouchInternals;
+  this->TUIOInternals->CursorFrame.Clear();
+  this->TUIOInternals->CursorFrame.LastFrame = -1;
+  this->TUIOInternals->ObjectFrame.Clear();
+  this->TUIOInternals->ObjectFrame.LastFrame = -1;
+  this->TUIOInternals->NumberOfCursors = 0;
+  this->TUIOInternals->NumberOfObjects = 0;
+  this->TUIOInternals->Time = 0.0;
+
+  this->Port = 3333;
+
+  this->FrameSequenceWindow = 1000;
+  this->NumberOfDroppedFrames = 0;
+
+  vtkMultiTouchGestureRecognizer* recognizer = vtkMultiTouchGestureRecognizer::New();
+  this->SetGestureRecognizer(recognizer);
+  recognizer->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkTUIOMultiTouch::~vtkTUIOMultiTouch() 
+{
+  // Initialize() may still be running on the background thread
+  this->JoinInitializeThread();
+
+  this->Disconnect();
+
+  delete this->TUIOInternals;
+}
+
+//----------------------------------------------------------------------------
+int vtkTUIOMultiTouch::Initialize() 
+{
+  if (this->GestureRecognizer == NULL)
+    {
+    vtkErrorMacro(<<"GestureRecognizer not set.");
+    return 0;
+    }
+
+  this->Disconnect();
+
+#ifdef WIN32
+  WSADATA wsaData;
+  if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) 
+    {
+    vtkErrorMacro(<<"WSAStartup failed.");
+    return 0;
+    }
+#endif
+
+  int s = static_cast<int>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+  if (s < 0)
+    {
+    vtkErrorMacro(<<"Could not create socket!");
+    return 0;
+    }
+
+  // Make non-blocking
+#ifdef WIN32
+  u_long nonBlocking = 1;
+  int blockingFailed = ioctlsocket(s, FIONBIO, &nonBlocking) != 0;
+#else
+  int blockingFailed = fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) < 0;
+#endif
+
+  struct sockaddr_in server;
+  memset(&server, 0, sizeof(server));
+  server.sin_family = AF_INET;
+  server.sin_port = htons(static_cast<unsigned short>(this->Port));
+  server.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  if (blockingFailed || bind(s, reinterpret_cast<struct sockaddr*>(&server), sizeof(server)) != 0)
+    {
+    vtkErrorMacro(<<"Could not bind socket to port " << this->Port << "!");
+#ifdef WIN32
+    closesocket(s);
+#else
+    close(s);
+#endif
+    return 0;
+    }
+
+  this->SocketDescriptor = s;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkTUIOMultiTouch::Disconnect()
+{
+  if (this->SocketDescriptor == -1) return;
+
+#ifdef WIN32
+  closesocket(this->SocketDescriptor);
+#else
+  close(this->SocketDescriptor);
+#endif
+  this->SocketDescriptor = -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkTUIOMultiTouch::ReceiveGesture() 
+{
+  vtkTUIOMultiTouchInternals* internals = this->TUIOInternals;
+
+  // Drain the socket, so touches are no more than a frame behind
+  while (1)
+    {
+    int size = static_cast<int>(recvfrom(this->SocketDescriptor, internals->Buffer, VTK_TUIO_MAX_PACKET, 0, NULL, NULL));
+    if (size <= 0) break;
+
+    internals->Time = vtkTimerLog::GetUniversalTime();
+    this->ParsePacket(internals->Buffer, size);
+    }
+
+  // The recognizer now classifies the cursors in Update()
+}
+
+//----------------------------------------------------------------------------
+void vtkTUIOMultiTouch::ParsePacket(const char* data, int size) 
+{
+  if (size >= 16 && memcmp(data, "#bundle", 8) == 0)
+    {
+    // Skip the time tag, then parse each element
+    const char* p = data + 16;
+    const char* end = data + size;
+
+    int elementSize;
+    while (ReadOSCInt(p, end, elementSize))
+      {
+      if (elementSize <= 0 || elementSize > end - p) break;
+
+      this->ParsePacket(p, elementSize);
+      p += elementSize;
+      }
+    }
+  else if (size > 0 && data[0] == '/')
+    {
+    this->ParseMessage(data, size);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTUIOMultiTouch::ParseMessage(const char* data, int size) 
+{
+  const char* p = data;
+  const char* end = data + size;
+
+  const char* address;
+  const char* types;
+  const char* command;
+  if (!ReadOSCString(p, end, address) || 
+      !ReadOSCString(p, end, types) || types[0] != ',' || types[1] != 's' ||
+      !ReadOSCString(p, end, command)) 
+    {
+    return;
+    }
+
+  int cursor = strcmp(address, "/tuio/2Dcur") == 0;
+  int object = strcmp(address, "/tuio/2Dobj") == 0;
+  if (!cursor && !object) return;
+
+  vtkTUIOFrame& frame = cursor ? this->TUIOInternals->CursorFrame : this->TUIOInternals->ObjectFrame;
+
+  // Arguments after the command
+  const char* type = types + 2;
+
+  if (strcmp(command, "alive") == 0)
+    {
+    frame.NumberOfAlive = 0;
+    frame.HasAlive = 1;
+
+    int id;
+    for (; *type == 'i' && ReadOSCInt(p, end, id); type++)
+      {
+      if (frame.NumberOfAlive < VTK_TUIO_MAX_FRAME) frame.Alive[frame.NumberOfAlive++] = id;
+      }
+    }
+  else if (strcmp(command, "set") == 0)
+    {
+    if (frame.NumberOfSets == VTK_TUIO_MAX_FRAME) return;
+
+    // 2Dcur:  s x y X Y m
+    // 2Dobj:  s i x y a X Y A m r
+    vtkTUIOSet& set = frame.Sets[frame.NumberOfSets];
+    set.ClassId = 0;
+    set.Angle = 0.0;
+
+    const char* cursorTypes = "ifffff";
+    const char* objectTypes = "iifffffff";
+    const char* expected = cursor ? cursorTypes : objectTypes;
+    if (strncmp(type, expected, strlen(expected)) != 0) return;
+
+    double rotationVelocity;
+    int ok = ReadOSCInt(p, end, set.SessionId);
+    if (object) 
+      {
+      ok = ok && ReadOSCInt(p, end, set.ClassId);
+      }
+    ok = ok && ReadOSCFloat(p, end, set.Location[0]) && ReadOSCFloat(p, end, set.Location[1]);
+    if (object) 
+      {
+      ok = ok && ReadOSCFloat(p, end, set.Angle);
+      }
+    ok = ok && ReadOSCFloat(p, end, set.Velocity[0]) && ReadOSCFloat(p, end, set.Velocity[1]);
+    if (object) 
+      {
+      ok = ok && ReadOSCFloat(p, end, rotationVelocity);
+      }
+    ok = ok && ReadOSCFloat(p, end, set.Acceleration);
+
+    if (ok) frame.NumberOfSets++;
+    }
+  else if (strcmp(command, "fseq") == 0)
+    {
+    int sequence;
+    if (*type != 'i' || !ReadOSCInt(p, end, sequence)) return;
+
+    if (cursor) this->ApplyCursorFrame(sequence);
+    else this->ApplyObjectFrame(sequence);
+    }
+  else
+    {
+    // source, and anything newer, is ignored
+    for (; *type; type++)
+      {
+      if (!SkipOSCArgument(p, end, *type)) return;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkTUIOMultiTouch::AcceptFrame(int frame, int& lastFrame) 
+{
+  // -1 marks frames that repeat the current state
+  if (frame == -1) return 1;
+
+  if (frame > lastFrame || lastFrame - frame > this->FrameSequenceWindow)
+    {
+    lastFrame = frame;
+    return 1;
+    }
+
+  this->NumberOfDroppedFrames++;
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkTUIOMultiTouch::ApplyCursorFrame(int sequence) 
+{
+  vtkTUIOMultiTouchInternals* internals = this->TUIOInternals;
+  vtkTUIOFrame& frame = internals->CursorFrame;
+
+  if (!this->AcceptFrame(sequence, frame.LastFrame))
+    {
+    frame.Clear();
+    return;
+    }
+
+  // Frames repeating the alive list are keep-alives, not new input
+  int changed = frame.NumberOfSets > 0;
+
+  // Lift cursors that are no longer alive
+  if (frame.HasAlive)
+    {
+    for (int i = 0; i < internals->NumberOfCursors; )
+      {
+      if (frame.IsAlive(internals->Cursors[i].Id))
+        {
+        i++;
+        continue;
+        }
+
+      this->GestureRecognizer->RemoveTouch(internals->Cursors[i].Id);
+      internals->Cursors[i] = internals->Cursors[--internals->NumberOfCursors];
+      changed = 1;
+      }
+    }
+
+  for (int i = 0; i < frame.NumberOfSets; i++)
+    {
+    const vtkTUIOSet& set = frame.Sets[i];
+
+    int j = 0;
+    while (j < internals->NumberOfCursors && internals->Cursors[j].Id != set.SessionId) j++;
+    if (j == internals->NumberOfCursors)
+      {
+      if (j == MaximumNumberOfCursors) continue;
+      internals->NumberOfCursors++;
+      }
+
+    TouchPoint& tp = internals->Cursors[j];
+    tp.Id = set.SessionId;
+    tp.Location[0] = set.Location[0];
+    tp.Location[1] = 1.0 - set.Location[1];
+    tp.Direction[0] = set.Velocity[0];
+    tp.Direction[1] = -set.Velocity[1];
+    tp.MoveLocation = set.Velocity[0] != 0.0 || set.Velocity[1] != 0.0;
+
+    if (!this->GestureRecognizer->SetTouch(tp.Id, tp.Location[0], tp.Location[1], internals->Time))
+      {
+      // The recognizer is full, so drop the new cursor
+      vtkWarningMacro(<<"Gesture recognizer full, ignoring cursor " << tp.Id << ".");
+      internals->Cursors[j] = internals->Cursors[--internals->NumberOfCursors];
+      }
+    }
+
+  if (changed) this->ReportReceived();
+
+  frame.Clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkTUIOMultiTouch::ApplyObjectFrame(int sequence) 
+{
+  vtkTUIOMultiTouchInternals* internals = this->TUIOInternals;
+  vtkTUIOFrame& frame = internals->ObjectFrame;
+
+  if (!this->AcceptFrame(sequence, frame.LastFrame))
+    {
+    frame.Clear();
+    return;
+    }
+
+  int changed = frame.NumberOfSets > 0;
+
+  if (frame.HasAlive)
+    {
+    for (int i = 0; i < internals->NumberOfObjects; )
+      {
+      if (frame.IsAlive(internals->Objects[i].SessionId)) 
+        {
+        i++;
+        continue;
+        }
+
+      internals->Objects[i] = internals->Objects[--internals->NumberOfObjects];
+      changed = 1;
+      }
+    }
+
+  for (int i = 0; i < frame.NumberOfSets; i++)
+    {
+    const vtkTUIOSet& set = frame.Sets[i];
+
+    int j = 0;
+    while (j < internals->NumberOfObjects && internals->Objects[j].SessionId != set.SessionId) j++;
+    if (j == internals->NumberOfObjects)
+      {
+      if (j == MaximumNumberOfObjects) continue;
+      internals->NumberOfObjects++;
+      }
+
+    TangibleObject& object = internals->Objects[j];
+    object.SessionId = set.SessionId;
+    object.ClassId = set.ClassId;
+    object.Location[0] = set.Location[0];
+    object.Location[1] = 1.0 - set.Location[1];
+    object.Angle = set.Angle;
+    }
+
+  if (changed) this->ReportReceived();
+
+  frame.Clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkTUIOMultiTouch::GetNumberOfCursors() 
+{
+  return this->TUIOInternals->NumberOfCursors;
+}
+
+//----------------------------------------------------------------------------
+const TouchPoint& vtkTUIOMultiTouch::GetCursor(int which) 
+{
+  return this->TUIOInternals->Cursors[which];
+}
+
+//----------------------------------------------------------------------------
+int vtkTUIOMultiTouch::GetNumberOfObjects() 
+{
+  return this->TUIOInternals->NumberOfObjects;
+}
+
+//----------------------------------------------------------------------------
+const TangibleObject& vtkTUIOMultiTouch::GetTangibleObject(int which) 
+{
+  return this->TUIOInternals->Objects[which];
+}
+
+//----------------------------------------------------------------------------
+void vtkTUIOMultiTouch::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "FrameSequenceWindow: " << this->FrameSequenceWindow << "\n";
+  os << indent << "NumberOfDroppedFrames: " << this->NumberOfDroppedFrames << "\n";
+  os << indent << "NumberOfCursors: " << this->TUIOInternals->NumberOfCursors << "\n";
+  os << indent << "NumberOfObjects: " << this->TUIOInternals->NumberOfObjects << "\n";
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Name:        vtkTUIOMultiTouch.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkTUIOMultiTouch
+// .SECTION Description
+// vtkTUIOMultiTouch receives touches from touch tables and trackers 
+// speaking TUIO 1.1 (http://www.tuio.org/) over OSC/UDP.  Cursors from 
+// /tuio/2Dcur are classified into gestures by a 
+// vtkMultiTouchGestureRecognizer, so the RENCI multi-touch styles work 
+// unchanged.  Tangible objects from /tuio/2Dobj are available with 
+// GetNumberOfObjects() and GetTangibleObject().
+//
+// Each profile's alive, set and fseq messages are applied together when
+// the fseq message arrives.  Frames older than the last one applied are 
+// dropped, as UDP can reorder packets, unless the sequence jumps back by 
+// more than FrameSequenceWindow, which means the tracker restarted.  
+// Only one TUIO source is supported per port.
+//
+// TUIO y coordinates run down the surface, so they are flipped to run up,
+// as in VTK display coordinates.  Packets are parsed in place, and 
+// cursors and objects are kept in fixed size tables, so receiving 
+// doesn't allocate.
+
+// .SECTION see also
+// vtkRenciMultiTouch vtkMultiTouchGestureRecognizer
+
+#ifndef __vtkTUIOMultiTouch_h
+#define __vtkTUIOMultiTouch_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkRenciMultiTouch.h"
+
+#include "vtkMultiTouchGestureRecognizer.h"  // For MaximumNumberOfCursors
+
+// Structure defining a tangible object
+struct TangibleObject
+{
+  int SessionId;
+  int ClassId;
+  double Location[2];
+  double Angle;
+};
+
+// Holds the cursor and object tables, which are hidden
+class vtkTUIOMultiTouchInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkTUIOMultiTouch : public vtkRenciMultiTouch
+{
+public:
+  static vtkTUIOMultiTouch* New();
+  vtkTypeRevisionMacro(vtkTUIOMultiTouch,vtkRenciMultiTouch);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Bind the socket to Port, 3333 by default.  HostName isn't used.
+  virtual int Initialize();
+
+  // Description:
+  // Get the cursors currently on the surface.  Ids are TUIO session ids,
+  // directions are velocities, and MoveLocation is 1 for moving cursors.
+  int GetNumberOfCursors();
+  //BTX
+  const TouchPoint& GetCursor(int which);
+  //ETX
+
+  // Description:
+  // Get the tangible objects currently on the surface
+  int GetNumberOfObjects();
+  //BTX
+  const TangibleObject& GetTangibleObject(int which);
+  //ETX
+
+  // Description:
+  // How far back the frame sequence can jump before it is taken as a 
+  // restart rather than a late packet
+  vtkSetClampMacro(FrameSequenceWindow,int,0,VTK_INT_MAX);
+  vtkGetMacro(FrameSequenceWindow,int);
+
+  // Description:
+  // Get the number of frames dropped as out of order
+  vtkGetMacro(NumberOfDroppedFrames,int);
+
+  // Cursors beyond what the recognizer can hold are ignored
+  //BTX
+  enum { MaximumNumberOfCursors = vtkMultiTouchGestureRecognizer::MaximumNumberOfTouches, 
+         MaximumNumberOfObjects = 256 };
+  //ETX
+
+protected:
+  vtkTUIOMultiTouch();
+  ~vtkTUIOMultiTouch();
+
+  int FrameSequenceWindow;
+  int NumberOfDroppedFrames;
+
+  vtkTUIOMultiTouchInternals* TUIOInternals;
+
+  // Description:
+  // Receive all waiting packets and pass the cursors to the recognizer
+  virtual void ReceiveGesture();
+
+  // Description:
+  // Close the socket
+  virtual void Disconnect();
+
+  // Description:
+  // Parse an OSC packet, which can be a bundle or a message
+  void ParsePacket(const char* data, int size);
+  void ParseMessage(const char* data, int size);
+
+  // Description:
+  // Apply a profile's frame when its fseq message arrives
+  void ApplyCursorFrame(int frame);
+  void ApplyObjectFrame(int frame);
+  int AcceptFrame(int frame, int& lastFrame);
+
+private:
+  vtkTUIOMultiTouch(const vtkTUIOMultiTouch&);  // Not implemented.
+  void operator=(const vtkTUIOMultiTouch&);  // Not implemented.
+};
+
+#endif
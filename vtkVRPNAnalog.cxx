@@ -16,6 +16,8 @@
 
 #include "vtkVRPNAnalog.h"
 
+#include "vtkDeviceStateStream.h"
+#include "vtkDoubleArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkstd/vector"
 
@@ -25,8 +27,24 @@ class vtkVRPNAnalogInternals
 {
 public:
   vtkstd::vector<double> Channel;
+
+  // Array wrapping Channel
+  vtkDoubleArray* ChannelArray;
 };
 
+// Point an array at the channel storage, if it has moved
+static void WrapChannels(vtkDoubleArray* array, vtkstd::vector<double>& channel)
+{
+  double* storage = channel.empty() ? NULL : &channel[0];
+  if (array->GetPointer(0) != storage || array->GetSize() != static_cast<vtkIdType>(channel.size()))
+    {
+    array->SetArray(storage, static_cast<vtkIdType>(channel.size()), 1);
+    }
+
+  // The storage is written directly, so the array can't tell it changed
+  array->Modified();
+}
+
 vtkCxxRevisionMacro(vtkVRPNAnalog, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkVRPNAnalog);
 
@@ -37,6 +55,8 @@ static void VRPN_CALLBACK HandleAnalog(void* userData, const vrpn_ANALOGCB a);
 vtkVRPNAnalog::vtkVRPNAnalog() 
 {
   this->Internals = new vtkVRPNAnalogInternals();
+  this->Internals->ChannelArray = vtkDoubleArray::New();
+  this->Internals->ChannelArray->SetName("Channel");
 
   this->Analog = NULL;
 
@@ -46,23 +66,21 @@ vtkVRPNAnalog::vtkVRPNAnalog()
 //----------------------------------------------------------------------------
 vtkVRPNAnalog::~vtkVRPNAnalog() 
 {
-  if (this->Analog) delete this->Analog;
+  // Initialize() may still be running on the background thread
+  this->JoinInitializeThread();
+
+  this->ReleaseRemote();
+
+  this->Internals->ChannelArray->Delete();
 
   delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
-int vtkVRPNAnalog::Initialize() 
+int vtkVRPNAnalog::CreateRemote() 
 {
-  // Check that the device name is set
-  if (this->DeviceName == NULL) 
-    {
-    vtkErrorMacro(<<"DeviceName not set.");
-    return 0;
-    }
-
   // Create the VRPN analog remote 
-  this->Analog = new vrpn_Analog_Remote(this->DeviceName);
+  this->Analog = new vrpn_Analog_Remote(this->DeviceName, this->Connection);
 
   // Set up the analog callback
   if (this->Analog->register_change_handler(this, HandleAnalog) == -1)
@@ -75,24 +93,47 @@ int vtkVRPNAnalog::Initialize()
 }
 
 //----------------------------------------------------------------------------
-void vtkVRPNAnalog::Update() 
+void vtkVRPNAnalog::DeleteRemote() 
 {
-  if (this->Analog)
-    {
-    this->Analog->mainloop();
-    }
+  if (this->Analog) delete this->Analog;
+  this->Analog = NULL;
+}
+
+//----------------------------------------------------------------------------
+vrpn_BaseClass* vtkVRPNAnalog::GetRemote() 
+{
+  return this->Analog;
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNAnalog::InvokeInteractionEvent() 
 {
-  if (this->Analog)
+  if (this->Analog || this->Replica)
     {
     // XXX: Should there be a flag to check for new data?
-    this->InvokeEvent(vtkVRPNDevice::AnalogEvent);
+    this->DispatchInteractionEvent(vtkVRPNDevice::AnalogEvent);
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkVRPNAnalog::WriteState(vtkDeviceStateStream* stream) 
+{
+  int n = this->GetNumberOfChannels();
+
+  stream->WriteInt(n);
+  if (n > 0) stream->WriteDoubles(&this->Internals->Channel[0], n);
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNAnalog::ReadState(vtkDeviceStateStream* stream) 
+{
+  int n = stream->ReadInt();
+  if (stream->GetError() || n < 0) return;
+
+  if (n != this->GetNumberOfChannels()) this->SetNumberOfChannels(n);
+  if (n > 0) stream->ReadDoubles(&this->Internals->Channel[0], n);
+}
+
 //----------------------------------------------------------------------------
 void vtkVRPNAnalog::SetNumberOfChannels(int num) 
 {
@@ -104,6 +145,9 @@ void vtkVRPNAnalog::SetNumberOfChannels(int num)
     {
     this->SetChannel(i, 0.0);
     }
+
+  // Arrays handed out earlier must not keep pointing at the old storage
+  WrapChannels(this->Internals->ChannelArray, this->Internals->Channel);
 }
 
 //----------------------------------------------------------------------------
@@ -115,25 +159,51 @@ int vtkVRPNAnalog::GetNumberOfChannels()
 //----------------------------------------------------------------------------
 void vtkVRPNAnalog::SetChannel(int channel, double value)
 {
+  if (channel < 0 || channel >= this->GetNumberOfChannels())
+    {
+    vtkErrorMacro(<<"Channel " << channel << " out of range.");
+    return;
+    }
+
   this->Internals->Channel[channel] = value;
 }
 
 //----------------------------------------------------------------------------
 double vtkVRPNAnalog::GetChannel(int channel)
 {
+  if (channel < 0 || channel >= this->GetNumberOfChannels())
+    {
+    vtkErrorMacro(<<"Channel " << channel << " out of range.");
+    return 0.0;
+    }
+
   return this->Internals->Channel[channel];
 }
 
+//----------------------------------------------------------------------------
+vtkDoubleArray* vtkVRPNAnalog::GetChannelArray()
+{
+  WrapChannels(this->Internals->ChannelArray, this->Internals->Channel);
+
+  return this->Internals->ChannelArray;
+}
+
 //----------------------------------------------------------------------------
 void VRPN_CALLBACK HandleAnalog(void* userData, const vrpn_ANALOGCB a) {
   vtkVRPNAnalog* analog = static_cast<vtkVRPNAnalog*>(userData);
 
   int num = analog->GetNumberOfChannels() < a.num_channel ? analog->GetNumberOfChannels() : a.num_channel;
 
+  // Analogs stream values while untouched, so only count reports that 
+  // change a channel
+  bool changed = false;
   for (int i = 0; i < num; i++)
     {
+    if (analog->GetChannel(i) != a.channel[i]) changed = true;
     analog->SetChannel(i, a.channel[i]);
     }
+
+  if (changed) analog->ReportReceived();
 }
 
 //----------------------------------------------------------------------------
@@ -29,6 +29,7 @@
 
 #include "vtkVRPNDevice.h"
 
+class vtkDoubleArray;
 class vrpn_Analog_Remote;
 
 // Holds vtkstd member variables, which must be hidden
@@ -41,18 +42,15 @@ public:
   vtkTypeRevisionMacro(vtkVRPNAnalog,vtkVRPNDevice);
   void PrintSelf(ostream&, vtkIndent);
 
-  // Description:
-  // Initialize the device
-  virtual int Initialize();
-
-  // Description:
-  // Receive updates from the device
-  virtual void Update();
-
   // Description:
   // Invoke vrpnDevice::AnalogEvent for observers to listen for
   virtual void InvokeInteractionEvent();
 
+  // Description:
+  // Write/read the state received in the last Update()
+  virtual void WriteState(vtkDeviceStateStream*);
+  virtual void ReadState(vtkDeviceStateStream*);
+
   // Description:
   // The number of channels to use
   void SetNumberOfChannels(int num);
@@ -63,12 +61,25 @@ public:
   void SetChannel(int channel, double value);
   double GetChannel(int channel);
 
+  // Description:
+  // Get all channels as an array.  The array uses the device's own 
+  // storage, so it always holds the latest values without copying, e.g.
+  // for viewing from NumPy.  The array is re-pointed when the number of 
+  // channels changes, but raw pointers taken from it must be taken again.
+  vtkDoubleArray* GetChannelArray();
+
 protected:
   vtkVRPNAnalog();
   ~vtkVRPNAnalog();
 
   vrpn_Analog_Remote* Analog;
 
+  // Description:
+  // Create/delete the VRPN remote
+  virtual int CreateRemote();
+  virtual void DeleteRemote();
+  virtual vrpn_BaseClass* GetRemote();
+
   vtkVRPNAnalogInternals* Internals;
 
 private:
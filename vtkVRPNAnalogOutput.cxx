@@ -17,54 +17,159 @@
 #include "vtkVRPNAnalogOutput.h"
 
 #include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
 #include "vtkstd/vector"
 
 #include <vrpn_Analog_Output.h>
 
+class vtkVRPNAnalogOutputInternals 
+{
+public:
+  // Desired values, and the values last sent to the device
+  vtkstd::vector<vrpn_float64> Channel;
+  vtkstd::vector<vrpn_float64> SentChannel;
+
+  // Whether each channel has been sent since the remote was created
+  vtkstd::vector<bool> Sent;
+};
+
 vtkCxxRevisionMacro(vtkVRPNAnalogOutput, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkVRPNAnalogOutput);
 
 //----------------------------------------------------------------------------
 vtkVRPNAnalogOutput::vtkVRPNAnalogOutput() 
 {
+  this->Internals = new vtkVRPNAnalogOutputInternals();
+
   this->AnalogOutput = NULL;
+
+  this->MinimumSendInterval = 0.0;
+  this->LastSendTime = 0.0;
 }
 
 //----------------------------------------------------------------------------
 vtkVRPNAnalogOutput::~vtkVRPNAnalogOutput() 
+{
+  // Initialize() may still be running on the background thread
+  this->JoinInitializeThread();
+
+  this->ReleaseRemote();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNAnalogOutput::CreateRemote() 
+{
+  // Create the VRPN analog remote 
+  this->AnalogOutput = new vrpn_Analog_Output_Remote(this->DeviceName, this->Connection);
+
+  // A new remote may be talking to a restarted server, so resend everything
+  this->Internals->Sent.assign(this->Internals->Sent.size(), false);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNAnalogOutput::DeleteRemote() 
 {
   if (this->AnalogOutput) delete this->AnalogOutput;
+  this->AnalogOutput = NULL;
+}
+
+//----------------------------------------------------------------------------
+vrpn_BaseClass* vtkVRPNAnalogOutput::GetRemote() 
+{
+  return this->AnalogOutput;
 }
 
 //----------------------------------------------------------------------------
-int vtkVRPNAnalogOutput::Initialize() 
+void vtkVRPNAnalogOutput::Update() 
 {
-  // Check that the device name is set
-  if (this->DeviceName == NULL) 
+  this->SendChannels();
+
+  this->Superclass::Update();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNAnalogOutput::SetChannel(int channel, double value)
+{
+  if (channel < 0 || channel >= vrpn_CHANNEL_MAX)
     {
-    vtkErrorMacro(<<"DeviceName not set.");
-    return 0;
+    vtkErrorMacro(<<"Channel " << channel << " out of range.");
+    return;
     }
 
-  // Create the VRPN analog remote 
-  this->AnalogOutput = new vrpn_Analog_Output_Remote(this->DeviceName);
+  if (channel >= this->GetNumberOfChannels())
+    {
+    this->Internals->Channel.resize(channel + 1, 0.0);
+    this->Internals->SentChannel.resize(channel + 1, 0.0);
+    this->Internals->Sent.resize(channel + 1, false);
+    }
 
-  return 1;
+  this->Internals->Channel[channel] = value;
 }
 
 //----------------------------------------------------------------------------
-void vtkVRPNAnalogOutput::Update() 
+double vtkVRPNAnalogOutput::GetChannel(int channel)
 {
-  if (this->AnalogOutput)
+  if (channel < 0 || channel >= this->GetNumberOfChannels())
     {
-    this->AnalogOutput->mainloop();
+    vtkErrorMacro(<<"Channel " << channel << " out of range.");
+    return 0.0;
     }
+
+  return this->Internals->Channel[channel];
 }
 
 //----------------------------------------------------------------------------
-void vtkVRPNAnalogOutput::SetChannel(int channel, double value)
+int vtkVRPNAnalogOutput::GetNumberOfChannels()
+{
+  return this->Internals->Channel.size();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNAnalogOutput::SendChannels()
 {
-  this->AnalogOutput->request_change_channel_value(channel, value);
+  if (this->AnalogOutput == NULL) return;
+
+  // Find the highest channel that needs sending
+  int num = 0;
+  for (int i = this->GetNumberOfChannels() - 1; i >= 0; i--)
+    {
+    if (!this->Internals->Sent[i] || 
+        this->Internals->Channel[i] != this->Internals->SentChannel[i])
+      {
+      num = i + 1;
+      break;
+      }
+    }
+
+  if (num == 0) return;
+
+  double time = vtkTimerLog::GetUniversalTime();
+  if (time - this->LastSendTime < this->MinimumSendInterval) return;
+
+  // Channels can only be sent as a prefix, so send everything up to the 
+  // highest changed channel in one message.  The connection may be being
+  // pumped by another thread.
+  this->LockConnection();
+  int success = this->AnalogOutput->request_change_channels(num, &this->Internals->Channel[0]);
+  this->UnlockConnection();
+
+  if (!success)
+    {
+    vtkErrorMacro(<<"Can't send channels.");
+    return;
+    }
+
+  for (int i = 0; i < num; i++)
+    {
+    this->Internals->SentChannel[i] = this->Internals->Channel[i];
+    this->Internals->Sent[i] = true;
+    }
+
+  this->LastSendTime = time;
 }
 
 //----------------------------------------------------------------------------
@@ -73,4 +178,6 @@ void vtkVRPNAnalogOutput::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "AnalogOutput: " << this->AnalogOutput << "\n";
+  os << indent << "NumberOfChannels: " << this->GetNumberOfChannels() << "\n";
+  os << indent << "MinimumSendInterval: " << this->MinimumSendInterval << "\n";
 }
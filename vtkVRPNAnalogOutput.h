@@ -42,20 +42,26 @@ public:
   void PrintSelf(ostream&, vtkIndent);
 
   // Description:
-  // Initialize the device
-  virtual int Initialize();
+  // No event 
+  virtual void InvokeInteractionEvent() {}
 
   // Description:
-  // Receive updates from the device
-  virtual void Update();
+  // Set the analog information.  Values are queued and only sent on the 
+  // next Update() if they differ from what was last sent.
+  void SetChannel(int channel, double value);
+  double GetChannel(int channel);
+  int GetNumberOfChannels();
 
   // Description:
-  // No event 
-  virtual void InvokeInteractionEvent() {}
+  // Send queued channel changes and receive updates from the device
+  virtual void Update();
 
   // Description:
-  // Set the analog information
-  void SetChannel(int channel, double value);
+  // Set/get the minimum time in seconds between sending changes.  Changes
+  // made in between are coalesced and sent once the interval has passed.
+  // The default of 0 sends changes at most once per Update().
+  vtkSetClampMacro(MinimumSendInterval,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MinimumSendInterval,double);
 
 protected:
   vtkVRPNAnalogOutput();
@@ -63,6 +69,21 @@ protected:
 
   vrpn_Analog_Output_Remote* AnalogOutput;
 
+  vtkVRPNAnalogOutputInternals* Internals;
+
+  double MinimumSendInterval;
+  double LastSendTime;
+
+  // Description:
+  // Send all changed channels in one request
+  void SendChannels();
+
+  // Description:
+  // Create/delete the VRPN remote
+  virtual int CreateRemote();
+  virtual void DeleteRemote();
+  virtual vrpn_BaseClass* GetRemote();
+
 private:
   vtkVRPNAnalogOutput(const vtkVRPNAnalogOutput&);  // Not implemented.
   void operator=(const vtkVRPNAnalogOutput&);  // Not implemented.
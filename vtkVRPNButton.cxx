@@ -16,7 +16,9 @@
 
 #include "vtkVRPNButton.h"
 
+#include "vtkDeviceStateStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkstd/vector"
 
 #include <vrpn_Button.h>
@@ -24,12 +26,33 @@
 class vtkVRPNButtonInternals
 {
 public:
-  vtkstd::vector<bool> Buttons;
+  // One byte per button, rather than vector<bool>'s packed bits, so the 
+  // storage can be shared with ButtonArray
+  vtkstd::vector<unsigned char> Buttons;
+
+  // Array wrapping Buttons
+  vtkUnsignedCharArray* ButtonArray;
+
+  // Transitions since the last event, as (button, state) pairs
+  vtkstd::vector<int> Transitions;
 };
 
 // Callbacks
 static void VRPN_CALLBACK HandleButton(void* userData, const vrpn_BUTTONCB b);
 
+// Point an array at the button storage, if it has moved
+static void WrapButtons(vtkUnsignedCharArray* array, vtkstd::vector<unsigned char>& buttons)
+{
+  unsigned char* storage = buttons.empty() ? NULL : &buttons[0];
+  if (array->GetPointer(0) != storage || array->GetSize() != static_cast<vtkIdType>(buttons.size()))
+    {
+    array->SetArray(storage, static_cast<vtkIdType>(buttons.size()), 1);
+    }
+
+  // The storage is written directly, so the array can't tell it changed
+  array->Modified();
+}
+
 vtkCxxRevisionMacro(vtkVRPNButton, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkVRPNButton);
 
@@ -37,6 +60,8 @@ vtkStandardNewMacro(vtkVRPNButton);
 vtkVRPNButton::vtkVRPNButton() 
 {
   this->Internals = new vtkVRPNButtonInternals;
+  this->Internals->ButtonArray = vtkUnsignedCharArray::New();
+  this->Internals->ButtonArray->SetName("Button");
 
   this->Button = NULL;
 
@@ -46,23 +71,21 @@ vtkVRPNButton::vtkVRPNButton()
 //----------------------------------------------------------------------------
 vtkVRPNButton::~vtkVRPNButton() 
 {
-  if (this->Button) delete this->Button;
+  // Initialize() may still be running on the background thread
+  this->JoinInitializeThread();
+
+  this->ReleaseRemote();
+
+  this->Internals->ButtonArray->Delete();
 
   delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
-int vtkVRPNButton::Initialize() 
+int vtkVRPNButton::CreateRemote() 
 {
-  // Check that the device name is set
-  if (this->DeviceName == NULL) 
-    {
-    vtkErrorMacro(<<"DeviceName not set.");
-    return 0;
-    }
-
   // Create the VRPN Button remote 
-  this->Button = new vrpn_Button_Remote(this->DeviceName);
+  this->Button = new vrpn_Button_Remote(this->DeviceName, this->Connection);
 
   // Set up the Button callback
   if (this->Button->register_change_handler(this, HandleButton) == -1)
@@ -75,21 +98,56 @@ int vtkVRPNButton::Initialize()
 }
 
 //----------------------------------------------------------------------------
-void vtkVRPNButton::Update() 
+void vtkVRPNButton::DeleteRemote() 
 {
-  if (this->Button)
-    {
-    this->Button->mainloop();
-    }
+  if (this->Button) delete this->Button;
+  this->Button = NULL;
+}
+
+//----------------------------------------------------------------------------
+vrpn_BaseClass* vtkVRPNButton::GetRemote() 
+{
+  return this->Button;
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNButton::InvokeInteractionEvent() 
 {
-  if (this->Button)
+  if (this->Button || this->Replica)
     {
     // XXX: Should there be a flag to check for new data?
-    this->InvokeEvent(vtkVRPNDevice::ButtonEvent);
+    this->DispatchInteractionEvent(vtkVRPNDevice::ButtonEvent);
+    }
+
+  this->Internals->Transitions.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNButton::WriteState(vtkDeviceStateStream* stream) 
+{
+  int n = this->GetNumberOfButtons();
+
+  stream->WriteInt(n);
+  if (n > 0) stream->WriteBits(&this->Internals->Buttons[0], n);
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNButton::ReadState(vtkDeviceStateStream* stream) 
+{
+  int n = stream->ReadInt();
+  if (stream->GetError() || n < 0) return;
+
+  if (n != this->GetNumberOfButtons()) this->SetNumberOfButtons(n);
+  if (n <= 0) return;
+
+  // Read into a copy, so the changes are recorded as transitions
+  vtkstd::vector<unsigned char> buttons(n);
+  stream->ReadBits(&buttons[0], n);
+  if (stream->GetError()) return;
+
+  for (int i = 0; i < n; i++) 
+    {
+    this->SetButton(i, buttons[i] != 0);
     }
 }
 
@@ -104,6 +162,9 @@ void vtkVRPNButton::SetNumberOfButtons(int num)
     {
     this->SetButton(i, false);
     }
+
+  // Arrays handed out earlier must not keep pointing at the old storage
+  WrapButtons(this->Internals->ButtonArray, this->Internals->Buttons);
 }
 
 //----------------------------------------------------------------------------
@@ -115,13 +176,49 @@ int vtkVRPNButton::GetNumberOfButtons()
 //----------------------------------------------------------------------------
 void vtkVRPNButton::SetButton(int button, bool value)
 {
-  this->Internals->Buttons[button] = value;
+  unsigned char state = value ? 1 : 0;
+  if (this->Internals->Buttons[button] == state) return;
+
+  this->Internals->Buttons[button] = state;
+
+  this->Internals->Transitions.push_back(button);
+  this->Internals->Transitions.push_back(state);
 }
 
 //----------------------------------------------------------------------------
 bool vtkVRPNButton::GetButton(int button)
 {
-  return this->Internals->Buttons[button];
+  return this->Internals->Buttons[button] != 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNButton::GetNumberOfTransitions()
+{
+  return static_cast<int>(this->Internals->Transitions.size() / 2);
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNButton::GetTransitionButton(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfTransitions()) return -1;
+
+  return this->Internals->Transitions[i * 2];
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNButton::GetTransitionState(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfTransitions()) return 0;
+
+  return this->Internals->Transitions[i * 2 + 1];
+}
+
+//----------------------------------------------------------------------------
+vtkUnsignedCharArray* vtkVRPNButton::GetButtonArray()
+{
+  WrapButtons(this->Internals->ButtonArray, this->Internals->Buttons);
+
+  return this->Internals->ButtonArray;
 }
 
 //----------------------------------------------------------------------------
@@ -137,9 +234,11 @@ void vtkVRPNButton::SetToggle(int button, bool toggle)
 void VRPN_CALLBACK HandleButton(void* userData, const vrpn_BUTTONCB b) {
   vtkVRPNButton* button = static_cast<vtkVRPNButton*>(userData);
 
-  if (b.button < button->GetNumberOfButtons())
+  if (b.button < button->GetNumberOfButtons() && 
+      button->GetButton(b.button) != (b.state != 0))
     {
     button->SetButton(b.button, b.state != 0);
+    button->ReportReceived();
     }
 }
 
@@ -153,7 +252,7 @@ void vtkVRPNButton::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Buttons: ";
   for (unsigned int i = 0; i < this->Internals->Buttons.size(); i++) 
     {
-    os << this->Internals->Buttons[i] << " ";
+    os << static_cast<int>(this->Internals->Buttons[i]) << " ";
     }
   os << "\n";
 }
@@ -29,6 +29,7 @@
 
 #include "vtkVRPNDevice.h"
 
+class vtkUnsignedCharArray;
 class vrpn_Button_Remote;
 
 // Holds vtkstd member variables, which must be hidden
@@ -41,18 +42,15 @@ public:
   vtkTypeRevisionMacro(vtkVRPNButton,vtkVRPNDevice);
   void PrintSelf(ostream&, vtkIndent);
 
-  // Description:
-  // Initialize the device
-  virtual int Initialize();
-
-  // Description:
-  // Receive updates from the device
-  virtual void Update();
-
   // Description:
   // Invoke vrpnDevice::ButtonEvent for observers to listen for
   virtual void InvokeInteractionEvent();
 
+  // Description:
+  // Write/read the state received in the last Update()
+  virtual void WriteState(vtkDeviceStateStream*);
+  virtual void ReadState(vtkDeviceStateStream*);
+
   // Description:
   // The number of buttons to use
   void SetNumberOfButtons(int num);
@@ -63,6 +61,23 @@ public:
   void SetButton(int button, bool value);
   bool GetButton(int button);
 
+  // Description:
+  // Get the button transitions since the last InvokeInteractionEvent(),
+  // in the order they arrived, so a press and release between two 
+  // updates isn't lost.  Replicas only see the transitions between the 
+  // states they read.
+  int GetNumberOfTransitions();
+  int GetTransitionButton(int i);
+  int GetTransitionState(int i);
+
+  // Description:
+  // Get all buttons as an array of 0s and 1s.  The array uses the 
+  // device's own storage, so it always holds the latest values without 
+  // copying, e.g. for viewing from NumPy.  The array is re-pointed when
+  // the number of buttons changes, but raw pointers taken from it must 
+  // be taken again.
+  vtkUnsignedCharArray* GetButtonArray();
+
   // Description:
   // Use toggle buttons or not.  Will have no effect until the device is initialized.
   void SetToggle(int button, bool toggle);
@@ -73,6 +88,12 @@ protected:
 
   vrpn_Button_Remote* Button;
 
+  // Description:
+  // Create/delete the VRPN remote
+  virtual int CreateRemote();
+  virtual void DeleteRemote();
+  virtual vrpn_BaseClass* GetRemote();
+
   vtkVRPNButtonInternals* Internals;
 
 private:
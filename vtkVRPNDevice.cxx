@@ -16,27 +16,280 @@
 
 #include "vtkVRPNDevice.h"
 
+#include "vtkMutexLock.h"
+#include "vtkstd/string"
+#include "vtkstd/vector"
+
+#include <vrpn_BaseClass.h>
+#include <vrpn_Connection.h>
+
+// A connection shared by all devices on one server
+struct vtkVRPNConnectionEntry
+{
+  vtkstd::string Server;
+  vrpn_Connection* Connection;
+  int ReferenceCount;
+
+  // Number of times the connection has been pumped
+  unsigned long PumpCount;
+
+  // Held while pumping the connection, or adding remotes to it or 
+  // deleting them from it
+  vtkSimpleMutexLock* Lock;
+};
+
+// Connections keyed by server address.  Broken connections stay in the 
+// pool until all their devices have released them.
+static vtkstd::vector<vtkVRPNConnectionEntry*> ConnectionPool;
+static vtkSimpleMutexLock ConnectionPoolLock;
+
+// Strip the device part from a "device@server" name
+static vtkstd::string GetServerAddress(const char* deviceName)
+{
+  vtkstd::string name(deviceName);
+  vtkstd::string::size_type at = name.find('@');
+
+  return at == vtkstd::string::npos ? name : name.substr(at + 1);
+}
+
+// Runs the client part of a remote's mainloop(), which VRPN keeps 
+// protected, without pumping the connection again
+struct vtkVRPNClientMainloop : public vrpn_BaseClass
+{
+  static void Run(vrpn_BaseClass* remote)
+    {
+    (remote->*&vtkVRPNClientMainloop::client_mainloop)();
+    }
+};
+
 vtkCxxRevisionMacro(vtkVRPNDevice, "$Revision: 1.0 $");
 
 //----------------------------------------------------------------------------
 vtkVRPNDevice::vtkVRPNDevice() 
 {
   this->DeviceName = NULL;
+  this->Connection = NULL;
+  this->SharedConnection = NULL;
+  this->PumpCount = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkVRPNDevice::~vtkVRPNDevice() 
-{  
+{
+  // Subclasses have already deleted their remotes
+  this->ReleaseConnection();
+
   if (this->DeviceName)
     {
     delete [] this->DeviceName;
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkVRPNDevice::Initialize() 
+{
+  // Check that the device name is set
+  if (this->DeviceName == NULL) 
+    {
+    vtkErrorMacro(<<"DeviceName not set.");
+    return 0;
+    }
+
+  // Get the shared connection to the server
+  if (!this->AcquireConnection())
+    {
+    return 0;
+    }
+
+  // The connection may be being pumped by another thread.  A remote left 
+  // from an earlier Initialize() is replaced.
+  this->SharedConnection->Lock->Lock();
+  if (this->GetRemote()) this->DeleteRemote();
+  int success = this->CreateRemote();
+  this->SharedConnection->Lock->Unlock();
+
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNDevice::Update() 
+{
+  this->Poll();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNDevice::Poll() 
+{
+  vrpn_BaseClass* remote = this->GetRemote();
+
+  if (remote == NULL || this->SharedConnection == NULL) return;
+
+  // Pumping the connection dispatches messages to the callbacks of every
+  // device using it, so only pump it if no other device has since this 
+  // one last polled.  The lock keeps devices updating on other threads 
+  // from pumping it at the same time.
+  vtkVRPNConnectionEntry* entry = this->SharedConnection;
+  entry->Lock->Lock();
+  if (this->PumpCount == entry->PumpCount)
+    {
+    entry->Connection->mainloop();
+    entry->PumpCount++;
+    }
+  this->PumpCount = entry->PumpCount;
+
+  // Each remote still does its own ping and liveness handling
+  vtkVRPNClientMainloop::Run(remote);
+  entry->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNDevice::AcquireConnection()
+{
+  if (this->SharedConnection) return 1;
+
+  vtkstd::string server = GetServerAddress(this->DeviceName);
+
+  ConnectionPoolLock.Lock();
+
+  vtkVRPNConnectionEntry* entry = NULL;
+  bool broken = false;
+  for (unsigned int i = 0; i < ConnectionPool.size(); i++)
+    {
+    if (ConnectionPool[i]->Server != server) continue;
+
+    if (ConnectionPool[i]->Connection->doing_okay())
+      {
+      entry = ConnectionPool[i];
+      break;
+      }
+
+    broken = true;
+    }
+
+  if (entry == NULL)
+    {
+    // First device on this server, or the old connection is broken.  VRPN
+    // hands out its cached connection for a name while it is referenced, 
+    // so force a new one to replace a broken connection.
+    vrpn_Connection* connection = vrpn_get_connection_by_name(server.c_str(), 
+      NULL, NULL, NULL, NULL, NULL, broken);
+
+    if (connection == NULL)
+      {
+      ConnectionPoolLock.Unlock();
+      vtkErrorMacro(<<"Can't create connection to " << server.c_str() << ".");
+      return 0;
+      }
+
+    entry = new vtkVRPNConnectionEntry;
+    entry->Server = server;
+    entry->Connection = connection;
+    entry->ReferenceCount = 0;
+    entry->PumpCount = 0;
+    entry->Lock = vtkSimpleMutexLock::New();
+
+    ConnectionPool.push_back(entry);
+    }
+
+  entry->ReferenceCount++;
+
+  ConnectionPoolLock.Unlock();
+
+  this->SharedConnection = entry;
+  this->Connection = entry->Connection;
+
+  // Pump at the next poll if no other device has
+  this->PumpCount = entry->PumpCount;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNDevice::ReleaseConnection()
+{
+  if (this->SharedConnection == NULL) return;
+
+  vtkVRPNConnectionEntry* entry = this->SharedConnection;
+
+  ConnectionPoolLock.Lock();
+
+  if (--entry->ReferenceCount == 0)
+    {
+    for (unsigned int i = 0; i < ConnectionPool.size(); i++)
+      {
+      if (ConnectionPool[i] == entry)
+        {
+        ConnectionPool.erase(ConnectionPool.begin() + i);
+        break;
+        }
+      }
+
+    entry->Connection->removeReference();
+    entry->Lock->Delete();
+    delete entry;
+    }
+
+  ConnectionPoolLock.Unlock();
+
+  this->SharedConnection = NULL;
+  this->Connection = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNDevice::ReleaseRemote()
+{
+  // Other devices may be pumping the connection the remote is on
+  this->LockConnection();
+  this->DeleteRemote();
+  this->UnlockConnection();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNDevice::LockConnection()
+{
+  if (this->SharedConnection) this->SharedConnection->Lock->Lock();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNDevice::UnlockConnection()
+{
+  if (this->SharedConnection) this->SharedConnection->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNDevice::CheckConnection()
+{
+  if (this->Connection == NULL || this->GetRemote() == NULL)
+    {
+    return vtkInteractionDevice::Disconnected;
+    }
+
+  if (this->Connection->connected())
+    {
+    return vtkInteractionDevice::Connected;
+    }
+
+  // VRPN keeps trying to connect until the connection breaks
+  if (this->Connection->doing_okay())
+    {
+    return vtkInteractionDevice::Connecting;
+    }
+
+  return vtkInteractionDevice::Disconnected;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNDevice::Disconnect()
+{
+  this->ReleaseRemote();
+  this->ReleaseConnection();
+}
+
 //----------------------------------------------------------------------------
 void vtkVRPNDevice::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "DeviceName: " << this->DeviceName << "\n";
+  os << indent << "Connection: " << this->Connection << "\n";
 }
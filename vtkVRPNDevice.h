@@ -18,6 +18,12 @@
 // vtkVRPNDevice is an abstract base class for interfacing with external 
 // devices using the Virtual Reality Peripheral Network (VRPN: 
 // http://www.cs.unc.edu/Research/vrpn/).  
+//
+// All vtkVRPNDevices connecting to the same server (the part of 
+// DeviceName after the '@') share a single vrpn_Connection, which is 
+// pumped once per round of updates, by the first of its devices to poll,
+// rather than once per device.  Each device still runs its remote's 
+// client housekeeping (pinging a silent server) every poll.
 
 // .SECTION see also
 // vtkInteractionDeviceManager vtkDeviceInteractorStyle
@@ -31,6 +37,12 @@
 
 #include "vtkCommand.h"
 
+class vrpn_BaseClass;
+class vrpn_Connection;
+
+// A pooled connection, hidden in the implementation
+struct vtkVRPNConnectionEntry;
+
 class VTK_INTERACTIONDEVICE_EXPORT vtkVRPNDevice : public vtkInteractionDevice
 {
 public:
@@ -41,12 +53,27 @@ public:
   // Set the name of the device to connect to.  Must be set before Initialize().
   vtkSetStringMacro(DeviceName);
 
+  // Description:
+  // Initialize the device.  Safe to call from a background thread, e.g. 
+  // via InitializeInBackground(), while other devices are being updated.
+  virtual int Initialize();
+
+  // Description:
+  // Receive updates from the device
+  virtual void Update();
+
+  // Description:
+  // Run the remote's mainloop(), so the callbacks take in the newest 
+  // reports between frames
+  virtual void Poll();
+
   // Enumeration for VRPN events
   //BTX
   enum VRPNEventIds {
       AnalogEvent = vtkCommand::UserEvent,
       ButtonEvent,
-      TrackerEvent
+      TrackerEvent,
+      ForceEvent
   };
   //ETX
 
@@ -56,6 +83,50 @@ protected:
 
   char* DeviceName;
 
+  // Description:
+  // Connection to the server named in DeviceName.  All vtkVRPNDevices on 
+  // the same server share one connection.
+  vrpn_Connection* Connection;
+  vtkVRPNConnectionEntry* SharedConnection;
+
+  // Number of pumps of the shared connection seen by the last Poll()
+  unsigned long PumpCount;
+
+  // Description:
+  // Get/release the shared connection for DeviceName from the pool.
+  int AcquireConnection();
+  void ReleaseConnection();
+
+  // Description:
+  // Lock/unlock the shared connection, e.g. for sending messages on it 
+  // while other devices may be pumping it.  Does nothing if there is no 
+  // connection.
+  void LockConnection();
+  void UnlockConnection();
+
+  // Description:
+  // Create/delete the VRPN remote using Connection.  Called with the 
+  // shared connection locked.
+  virtual int CreateRemote() = 0;
+  virtual void DeleteRemote() = 0;
+
+  // Description:
+  // Delete the remote with the shared connection locked.  Subclass 
+  // destructors call this instead of deleting their remote directly.
+  void ReleaseRemote();
+
+  // Description:
+  // Get the VRPN remote, or NULL if there isn't one
+  virtual vrpn_BaseClass* GetRemote() = 0;
+
+  // Description:
+  // Connection state of the shared connection
+  virtual int CheckConnection();
+
+  // Description:
+  // Delete the remote and release the shared connection
+  virtual void Disconnect();
+
 private:
   vtkVRPNDevice(const vtkVRPNDevice&);  // Not implemented.
   void operator=(const vtkVRPNDevice&);  // Not implemented.
@@ -0,0 +1,695 @@
+/*=========================================================================
+
+  Name:        vtkVRPNForceDevice.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkVRPNForceDevice.h"
+
+#include "vtkDeviceStateStream.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+
+#ifdef WIN32
+# include "vtkWindows.h"
+# include <mmsystem.h>
+#else
+# include <time.h>
+#endif
+
+#include <vrpn_Connection.h>
+#include <vrpn_ForceDevice.h>
+#include <vrpn_Tracker.h>
+
+// Device state, in the device's coordinate system
+struct vtkVRPNForceDeviceState
+{
+  double Position[3];
+  double Rotation[4];
+  double Force[3];
+};
+
+// Force field and constraint set by styles
+struct vtkVRPNForceDeviceEffects
+{
+  int FieldEnabled;
+  double FieldOrigin[3];
+  double FieldForce[3];
+  double FieldJacobian[9];
+  double FieldRadius;
+
+  int ConstraintType;
+  double ConstraintPoint[3];
+  double ConstraintDirection[3];
+  double ConstraintStiffness;
+
+  double MaximumForce;
+  double LinearizationRadius;
+};
+
+class vtkVRPNForceDeviceInternals
+{
+public:
+  vtkMultiThreader* Threader;
+  int ThreadId;
+
+  // Guards Snapshot, Effects, Stop and MeasuredServoRate.  Only held to 
+  // copy them, never while calling into VRPN.
+  vtkSimpleMutexLock* Lock;
+
+  int Stop;
+
+  // Written by the tracker and force callbacks in the servo thread
+  vtkVRPNForceDeviceState ServoState;
+
+  // Copy of ServoState published by the servo thread for Update()
+  vtkVRPNForceDeviceState Snapshot;
+
+  // Written by the main thread, and copied once per servo step
+  vtkVRPNForceDeviceEffects Effects;
+  vtkVRPNForceDeviceEffects ServoEffects;
+
+  // Whether a force field is active on the server
+  int Sending;
+
+  double MeasuredServoRate;
+  int StepCount;
+  double StepCountStartTime;
+};
+
+// Callbacks
+static void VRPN_CALLBACK HandleServoPosition(void* userData, const vrpn_TRACKERCB t);
+static void VRPN_CALLBACK HandleServoForce(void* userData, const vrpn_FORCECB f);
+
+// Sleep until the deadline, in seconds since 1970.  POSIX sleeps have 
+// sub-millisecond resolution.  Windows sleeps in whole timer ticks, which 
+// the servo thread sets to 1 ms, so at kHz rates a step can oversleep, 
+// and the deadlines then make up for it by not sleeping next step.
+static void SleepUntil(double deadline)
+{
+  double remaining = deadline - vtkTimerLog::GetUniversalTime();
+  if (remaining <= 0.0) return;
+
+#ifdef WIN32
+  DWORD ms = static_cast<DWORD>(remaining * 1000.0);
+  Sleep(ms > 0 ? ms : 1);
+#else
+  struct timespec duration;
+  duration.tv_sec = static_cast<time_t>(remaining);
+  duration.tv_nsec = static_cast<long>((remaining - duration.tv_sec) * 1.0e9);
+  nanosleep(&duration, NULL);
+#endif
+}
+
+vtkCxxRevisionMacro(vtkVRPNForceDevice, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkVRPNForceDevice);
+
+//----------------------------------------------------------------------------
+vtkVRPNForceDevice::vtkVRPNForceDevice() 
+{
+  this->Internals = new vtkVRPNForceDeviceInternals();
+  this->Internals->Threader = vtkMultiThreader::New();
+  this->Internals->ThreadId = -1;
+  this->Internals->Lock = vtkSimpleMutexLock::New();
+  this->Internals->Stop = 0;
+  this->Internals->Sending = 0;
+  this->Internals->MeasuredServoRate = 0.0;
+  this->Internals->StepCount = 0;
+  this->Internals->StepCountStartTime = 0.0;
+
+  this->ForceDevice = NULL;
+  this->Tracker = NULL;
+
+  this->Position[0] = this->Position[1] = this->Position[2] = 0.0;
+  this->Rotation[0] = 1.0;
+  this->Rotation[1] = this->Rotation[2] = this->Rotation[3] = 0.0;
+  this->Force[0] = this->Force[1] = this->Force[2] = 0.0;
+
+  this->MaximumForce = 3.0;
+  this->LinearizationRadius = 0.01;
+  this->ServoRate = 1000.0;
+
+  vtkVRPNForceDeviceState* state = &this->Internals->ServoState;
+  for (int i = 0; i < 3; i++) state->Position[i] = state->Force[i] = 0.0;
+  for (int i = 0; i < 4; i++) state->Rotation[i] = this->Rotation[i];
+  this->Internals->Snapshot = *state;
+
+  vtkVRPNForceDeviceEffects* effects = &this->Internals->Effects;
+  effects->FieldEnabled = 0;
+  effects->ConstraintType = vtkVRPNForceDevice::NoConstraint;
+  effects->MaximumForce = this->MaximumForce;
+  effects->LinearizationRadius = this->LinearizationRadius;
+  this->Internals->ServoEffects = *effects;
+}
+
+//----------------------------------------------------------------------------
+vtkVRPNForceDevice::~vtkVRPNForceDevice() 
+{
+  // Initialize() may still be running on the background thread
+  this->JoinInitializeThread();
+
+  this->DeleteRemote();
+
+  if (this->Connection)
+    {
+    this->Connection->removeReference();
+    this->Connection = NULL;
+    }
+
+  this->Internals->Lock->Delete();
+  this->Internals->Threader->Delete();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNForceDevice::Initialize() 
+{
+  // Check that the device name is set
+  if (this->DeviceName == NULL) 
+    {
+    vtkErrorMacro(<<"DeviceName not set.");
+    return 0;
+    }
+
+  // Use a dedicated connection rather than the shared one, so the servo 
+  // thread can pump it without contending with other devices
+  if (this->Connection == NULL)
+    {
+    this->Connection = vrpn_get_connection_by_name(this->DeviceName, 
+                                                   NULL, NULL, NULL, NULL, NULL, 
+                                                   true);
+
+    if (this->Connection == NULL)
+      {
+      vtkErrorMacro(<<"Can't create connection to " << this->DeviceName << ".");
+      return 0;
+      }
+    }
+
+  // Replace the remotes and servo thread of an earlier Initialize()
+  this->DeleteRemote();
+
+  return this->CreateRemote();
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNForceDevice::CreateRemote() 
+{
+  // Create the VRPN remotes 
+  this->ForceDevice = new vrpn_ForceDevice_Remote(this->DeviceName, this->Connection);
+  this->Tracker = new vrpn_Tracker_Remote(this->DeviceName, this->Connection);
+
+  // Set up the callbacks, which are called from the servo thread
+  if (this->Tracker->register_change_handler(this->Internals, HandleServoPosition) == -1 ||
+      this->ForceDevice->register_force_change_handler(this->Internals, HandleServoForce) == -1)
+    {
+    vtkErrorMacro(<<"Can't register callback.");
+    return 0;
+    }
+
+  // Start the servo thread
+  this->Internals->Stop = 0;
+  this->Internals->Sending = 0;
+  this->Internals->StepCount = 0;
+  this->Internals->StepCountStartTime = vtkTimerLog::GetUniversalTime();
+  this->Internals->ThreadId = this->Internals->Threader->SpawnThread(vtkVRPNForceDevice::ServoThread, this);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::DeleteRemote() 
+{
+  // Stop the servo thread before deleting the remotes it uses
+  if (this->Internals->ThreadId >= 0)
+    {
+    this->Internals->Lock->Lock();
+    this->Internals->Stop = 1;
+    this->Internals->Lock->Unlock();
+
+    this->Internals->Threader->TerminateThread(this->Internals->ThreadId);
+    this->Internals->ThreadId = -1;
+    }
+
+  if (this->ForceDevice) 
+    {
+    if (this->Internals->Sending) 
+      {
+      // Messages are only sent when the connection is pumped, so flush 
+      // the stop before the remote goes, or the device keeps pushing
+      this->ForceDevice->stopForceField();
+      if (this->Connection) this->Connection->mainloop();
+      this->Internals->Sending = 0;
+      }
+    delete this->ForceDevice;
+    }
+  this->ForceDevice = NULL;
+
+  if (this->Tracker) delete this->Tracker;
+  this->Tracker = NULL;
+}
+
+//----------------------------------------------------------------------------
+vrpn_BaseClass* vtkVRPNForceDevice::GetRemote() 
+{
+  return this->ForceDevice;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::Disconnect() 
+{
+  // Not on the shared connection, so nothing else needs locking
+  this->DeleteRemote();
+
+  if (this->Connection)
+    {
+    this->Connection->removeReference();
+    this->Connection = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::Update() 
+{
+  // The servo thread pumps the connection, so just take the latest state
+  this->Internals->Lock->Lock();
+  vtkVRPNForceDeviceState state = this->Internals->Snapshot;
+  this->Internals->Lock->Unlock();
+
+  for (int i = 0; i < 3; i++) 
+    {
+    this->Position[i] = state.Position[i];
+    this->Force[i] = state.Force[i];
+    }
+  for (int i = 0; i < 4; i++) 
+    {
+    this->Rotation[i] = state.Rotation[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::InvokeInteractionEvent() 
+{
+  if (this->ForceDevice || this->Replica)
+    {
+    this->DispatchInteractionEvent(vtkVRPNDevice::ForceEvent);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::WriteState(vtkDeviceStateStream* stream) 
+{
+  stream->WritePositions(this->Position, 3);
+  stream->WriteRotations(this->Rotation, 4);
+  stream->WriteDoubles(this->Force, 3);
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::ReadState(vtkDeviceStateStream* stream) 
+{
+  stream->ReadPositions(this->Position, 3);
+  stream->ReadRotations(this->Rotation, 4);
+  stream->ReadDoubles(this->Force, 3);
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::SetForceField(double origin[3], double force[3], double jacobian[9], double radius) 
+{
+  this->Internals->Lock->Lock();
+
+  vtkVRPNForceDeviceEffects* effects = &this->Internals->Effects;
+  effects->FieldEnabled = 1;
+  for (int i = 0; i < 3; i++)
+    {
+    effects->FieldOrigin[i] = origin[i];
+    effects->FieldForce[i] = force[i];
+    }
+  for (int i = 0; i < 9; i++)
+    {
+    effects->FieldJacobian[i] = jacobian[i];
+    }
+  effects->FieldRadius = radius;
+
+  this->Internals->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::RemoveForceField() 
+{
+  this->Internals->Lock->Lock();
+  this->Internals->Effects.FieldEnabled = 0;
+  this->Internals->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::SetPointConstraint(double point[3], double stiffness) 
+{
+  this->Internals->Lock->Lock();
+
+  vtkVRPNForceDeviceEffects* effects = &this->Internals->Effects;
+  effects->ConstraintType = vtkVRPNForceDevice::PointConstraint;
+  for (int i = 0; i < 3; i++) 
+    {
+    effects->ConstraintPoint[i] = point[i];
+    }
+  effects->ConstraintStiffness = stiffness;
+
+  this->Internals->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::SetLineConstraint(double point[3], double direction[3], double stiffness) 
+{
+  double d[3] = { direction[0], direction[1], direction[2] };
+  if (vtkMath::Normalize(d) == 0.0)
+    {
+    vtkErrorMacro(<<"Line direction is zero.");
+    return;
+    }
+
+  this->Internals->Lock->Lock();
+
+  vtkVRPNForceDeviceEffects* effects = &this->Internals->Effects;
+  effects->ConstraintType = vtkVRPNForceDevice::LineConstraint;
+  for (int i = 0; i < 3; i++) 
+    {
+    effects->ConstraintPoint[i] = point[i];
+    effects->ConstraintDirection[i] = d[i];
+    }
+  effects->ConstraintStiffness = stiffness;
+
+  this->Internals->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::SetPlaneConstraint(double point[3], double normal[3], double stiffness) 
+{
+  double n[3] = { normal[0], normal[1], normal[2] };
+  if (vtkMath::Normalize(n) == 0.0)
+    {
+    vtkErrorMacro(<<"Plane normal is zero.");
+    return;
+    }
+
+  this->Internals->Lock->Lock();
+
+  vtkVRPNForceDeviceEffects* effects = &this->Internals->Effects;
+  effects->ConstraintType = vtkVRPNForceDevice::PlaneConstraint;
+  for (int i = 0; i < 3; i++) 
+    {
+    effects->ConstraintPoint[i] = point[i];
+    effects->ConstraintDirection[i] = n[i];
+    }
+  effects->ConstraintStiffness = stiffness;
+
+  this->Internals->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::SetMaximumForce(double force) 
+{
+  if (force < 0.0) force = 0.0;
+  if (force == this->MaximumForce) return;
+
+  // The servo thread reads the copy in Effects
+  this->Internals->Lock->Lock();
+  this->MaximumForce = force;
+  this->Internals->Effects.MaximumForce = force;
+  this->Internals->Lock->Unlock();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::SetLinearizationRadius(double radius) 
+{
+  if (radius < 0.0) radius = 0.0;
+  if (radius == this->LinearizationRadius) return;
+
+  this->Internals->Lock->Lock();
+  this->LinearizationRadius = radius;
+  this->Internals->Effects.LinearizationRadius = radius;
+  this->Internals->Lock->Unlock();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::RemoveConstraint() 
+{
+  this->Internals->Lock->Lock();
+  this->Internals->Effects.ConstraintType = vtkVRPNForceDevice::NoConstraint;
+  this->Internals->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+double vtkVRPNForceDevice::GetMeasuredServoRate() 
+{
+  this->Internals->Lock->Lock();
+  double rate = this->Internals->MeasuredServoRate;
+  this->Internals->Lock->Unlock();
+
+  return rate;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkVRPNForceDevice::ServoThread(void* arg) 
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkVRPNForceDevice* self = static_cast<vtkVRPNForceDevice*>(info->UserData);
+  vtkVRPNForceDeviceInternals* internals = self->Internals;
+
+  double period = 1.0 / self->ServoRate;
+  double nextTime = vtkTimerLog::GetUniversalTime();
+
+#ifdef WIN32
+  // Sleep in 1 ms ticks rather than the default 15.6 ms
+  timeBeginPeriod(1);
+#endif
+
+  while (true)
+    {
+    internals->Lock->Lock();
+    int stop = internals->Stop;
+    internals->Lock->Unlock();
+
+    if (stop) break;
+
+    self->ServoStep();
+
+    // Sleep until the next step's deadline
+    nextTime += period;
+    double time = vtkTimerLog::GetUniversalTime();
+
+    if (nextTime < time - period)
+      {
+      // Fell behind, so don't try to catch up
+      nextTime = time;
+      }
+
+    SleepUntil(nextTime);
+    }
+
+#ifdef WIN32
+  timeEndPeriod(1);
+#endif
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::ServoStep() 
+{
+  vtkVRPNForceDeviceInternals* internals = this->Internals;
+
+  // Receive the latest reports, updating ServoState via the callbacks
+  this->ForceDevice->mainloop();
+  this->Tracker->mainloop();
+
+  // Publish the state and pick up any new effects
+  double time = vtkTimerLog::GetUniversalTime();
+
+  internals->Lock->Lock();
+  internals->Snapshot = internals->ServoState;
+  internals->ServoEffects = internals->Effects;
+
+  internals->StepCount++;
+  if (time - internals->StepCountStartTime >= 1.0)
+    {
+    internals->MeasuredServoRate = internals->StepCount / (time - internals->StepCountStartTime);
+    internals->StepCount = 0;
+    internals->StepCountStartTime = time;
+    }
+  internals->Lock->Unlock();
+
+  const vtkVRPNForceDeviceEffects& effects = internals->ServoEffects;
+  const double* p = internals->ServoState.Position;
+
+  if (!effects.FieldEnabled && effects.ConstraintType == vtkVRPNForceDevice::NoConstraint)
+    {
+    if (internals->Sending) 
+      {
+      this->ForceDevice->stopForceField();
+      internals->Sending = 0;
+      }
+    return;
+    }
+
+  // Evaluate the force and its jacobian at the current position
+  double force[3] = { 0.0, 0.0, 0.0 };
+  double jacobian[3][3] = { { 0.0, 0.0, 0.0 }, 
+                            { 0.0, 0.0, 0.0 }, 
+                            { 0.0, 0.0, 0.0 } };
+
+  if (effects.FieldEnabled &&
+      sqrt(vtkMath::Distance2BetweenPoints(p, effects.FieldOrigin)) <= effects.FieldRadius)
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      force[i] += effects.FieldForce[i];
+      for (int j = 0; j < 3; j++)
+        {
+        double jij = effects.FieldJacobian[i * 3 + j];
+        force[i] += jij * (p[j] - effects.FieldOrigin[j]);
+        jacobian[i][j] += jij;
+        }
+      }
+    }
+
+  if (effects.ConstraintType != vtkVRPNForceDevice::NoConstraint)
+    {
+    const double k = effects.ConstraintStiffness;
+    const double* c = effects.ConstraintPoint;
+    const double* d = effects.ConstraintDirection;
+
+    double v[3] = { p[0] - c[0], p[1] - c[1], p[2] - c[2] };
+
+    switch (effects.ConstraintType)
+      {
+      case vtkVRPNForceDevice::PointConstraint:
+        // Spring to the point:  F = -k v
+        for (int i = 0; i < 3; i++)
+          {
+          force[i] -= k * v[i];
+          jacobian[i][i] -= k;
+          }
+        break;
+
+      case vtkVRPNForceDevice::LineConstraint:
+        {
+        // Spring to the closest point on the line:  F = -k (I - d d^T) v
+        double along = vtkMath::Dot(v, d);
+        for (int i = 0; i < 3; i++)
+          {
+          force[i] -= k * (v[i] - along * d[i]);
+          for (int j = 0; j < 3; j++)
+            {
+            jacobian[i][j] -= k * ((i == j ? 1.0 : 0.0) - d[i] * d[j]);
+            }
+          }
+        }
+        break;
+
+      case vtkVRPNForceDevice::PlaneConstraint:
+        {
+        // Spring to the closest point on the plane:  F = -k (n n^T) v
+        double distance = vtkMath::Dot(v, d);
+        for (int i = 0; i < 3; i++)
+          {
+          force[i] -= k * distance * d[i];
+          for (int j = 0; j < 3; j++)
+            {
+            jacobian[i][j] -= k * d[i] * d[j];
+            }
+          }
+        }
+        break;
+      }
+    }
+
+  // Clamp the force, scaling the field with it
+  double magnitude = vtkMath::Norm(force);
+  double scale = magnitude > effects.MaximumForce && magnitude > 0.0 ? 
+                 effects.MaximumForce / magnitude : 1.0;
+
+  // Send the field linearized about the current position
+  vrpn_float32 origin32[3];
+  vrpn_float32 force32[3];
+  vrpn_float32 jacobian32[3][3];
+  for (int i = 0; i < 3; i++)
+    {
+    origin32[i] = static_cast<vrpn_float32>(p[i]);
+    force32[i] = static_cast<vrpn_float32>(force[i] * scale);
+    for (int j = 0; j < 3; j++)
+      {
+      jacobian32[i][j] = static_cast<vrpn_float32>(jacobian[i][j] * scale);
+      }
+    }
+
+  this->ForceDevice->sendForceField(origin32, force32, jacobian32, 
+                                    static_cast<vrpn_float32>(effects.LinearizationRadius));
+  internals->Sending = 1;
+}
+
+//----------------------------------------------------------------------------
+void VRPN_CALLBACK HandleServoPosition(void* userData, const vrpn_TRACKERCB t) {
+  vtkVRPNForceDeviceInternals* internals = static_cast<vtkVRPNForceDeviceInternals*>(userData);
+
+  if (t.sensor == 0) 
+    {
+    vtkVRPNForceDeviceState* state = &internals->ServoState;
+
+    for (int i = 0; i < 3; i++) 
+      {
+      state->Position[i] = t.pos[i];
+      }
+
+    // Convert from vrpn quaternion (x, y, z, w) to vtk quaternion (w, x, y, z)
+    state->Rotation[0] = t.quat[3];
+    state->Rotation[1] = t.quat[0];
+    state->Rotation[2] = t.quat[1];
+    state->Rotation[3] = t.quat[2];
+    }
+}
+
+//----------------------------------------------------------------------------
+void VRPN_CALLBACK HandleServoForce(void* userData, const vrpn_FORCECB f) {
+  vtkVRPNForceDeviceInternals* internals = static_cast<vtkVRPNForceDeviceInternals*>(userData);
+
+  for (int i = 0; i < 3; i++) 
+    {
+    internals->ServoState.Force[i] = f.force[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNForceDevice::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "ForceDevice: " << this->ForceDevice << "\n";
+  os << indent << "Tracker: " << this->Tracker << "\n";
+  os << indent << "Position: " << this->Position[0] << " " 
+     << this->Position[1] << " " << this->Position[2] << "\n";
+  os << indent << "Rotation: " << this->Rotation[0] << " " 
+     << this->Rotation[1] << " " << this->Rotation[2] << " " 
+     << this->Rotation[3] << "\n";
+  os << indent << "Force: " << this->Force[0] << " " 
+     << this->Force[1] << " " << this->Force[2] << "\n";
+  os << indent << "MaximumForce: " << this->MaximumForce << "\n";
+  os << indent << "LinearizationRadius: " << this->LinearizationRadius << "\n";
+  os << indent << "ServoRate: " << this->ServoRate << "\n";
+}
@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Name:        vtkVRPNForceDevice.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkVRPNForceDevice
+// .SECTION Description
+// vtkVRPNForceDevice interfaces with a force-feedback device, e.g. a 
+// Phantom, using the Virtual Reality Peripheral Network (VRPN: 
+// http://www.cs.unc.edu/Research/vrpn/).  
+//
+// Haptic rendering needs a stable control loop of around 1 kHz, so 
+// unlike other vtkVRPNDevices this device runs its own servo thread on a 
+// dedicated connection instead of being pumped by Update().  Each servo 
+// step reads the latest tracker report for the device, evaluates the 
+// force field and constraint set by styles at that position, and sends 
+// the result to the server as a force field linearized about the current
+// position.  Update() only copies the latest state from the servo thread,
+// so the force output is unaffected by the rendering frame rate.
+//
+// The same DeviceName is used for the force device and tracker remotes, 
+// as is usual for VRPN force device servers.
+
+// .SECTION see also
+// vtkInteractionDeviceManager vtkDeviceInteractorStyle
+
+#ifndef __vtkVRPNForceDevice_h
+#define __vtkVRPNForceDevice_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkVRPNDevice.h"
+
+class vrpn_ForceDevice_Remote;
+class vrpn_Tracker_Remote;
+
+// Holds the servo thread state, which must be hidden
+class vtkVRPNForceDeviceInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkVRPNForceDevice : public vtkVRPNDevice
+{
+public:
+  static vtkVRPNForceDevice* New();
+  vtkTypeRevisionMacro(vtkVRPNForceDevice,vtkVRPNDevice);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Connect to the device and start the servo thread
+  virtual int Initialize();
+
+  // Description:
+  // Copy the latest state from the servo thread
+  virtual void Update();
+
+  // Description:
+  // The servo thread receives the reports, so there is nothing to poll
+  virtual void Poll() {}
+
+  // Description:
+  // Invoke vtkVRPNDevice::ForceEvent for observers to listen for
+  virtual void InvokeInteractionEvent();
+
+  // Description:
+  // Write/read the state received in the last Update()
+  virtual void WriteState(vtkDeviceStateStream*);
+  virtual void ReadState(vtkDeviceStateStream*);
+
+  // Description:
+  // Get the device state as of the last Update()
+  vtkGetVector3Macro(Position,double);
+  vtkGetVector4Macro(Rotation,double);
+  vtkGetVector3Macro(Force,double);
+
+  // Description:
+  // Set a force field, F = force + jacobian * (p - origin), applied within
+  // radius of origin.  The jacobian is in row-major order.
+  void SetForceField(double origin[3], double force[3], double jacobian[9], double radius);
+  void RemoveForceField();
+
+  // Description:
+  // Set a constraint pulling the device onto a point, line or plane with 
+  // a spring of the given stiffness.  Only one constraint is active at a
+  // time.
+  void SetPointConstraint(double point[3], double stiffness);
+  void SetLineConstraint(double point[3], double direction[3], double stiffness);
+  void SetPlaneConstraint(double point[3], double normal[3], double stiffness);
+  void RemoveConstraint();
+
+  // Description:
+  // Set/get the maximum magnitude of the force sent to the device
+  void SetMaximumForce(double force);
+  vtkGetMacro(MaximumForce,double);
+
+  // Description:
+  // Set/get the radius about the current position within which the server
+  // applies each linearized force field.  Should cover the distance the 
+  // device can move in one servo step.
+  void SetLinearizationRadius(double radius);
+  vtkGetMacro(LinearizationRadius,double);
+
+  // Description:
+  // Set/get the servo loop rate in Hz.  Takes effect on the next 
+  // Initialize().
+  vtkSetClampMacro(ServoRate,double,1.0,10000.0);
+  vtkGetMacro(ServoRate,double);
+
+  // Description:
+  // Get the servo loop rate achieved over the last second
+  double GetMeasuredServoRate();
+
+  // Enumeration for constraints
+  //BTX
+  enum ConstraintTypes {
+      NoConstraint = 0,
+      PointConstraint,
+      LineConstraint,
+      PlaneConstraint
+  };
+  //ETX
+
+protected:
+  vtkVRPNForceDevice();
+  ~vtkVRPNForceDevice();
+
+  vrpn_ForceDevice_Remote* ForceDevice;
+  vrpn_Tracker_Remote* Tracker;
+
+  // Description:
+  // Create/delete the VRPN remotes, starting/stopping the servo thread
+  virtual int CreateRemote();
+  virtual void DeleteRemote();
+  virtual vrpn_BaseClass* GetRemote();
+
+  // Description:
+  // Also release the dedicated connection
+  virtual void Disconnect();
+
+  double Position[3];
+  double Rotation[4];
+  double Force[3];
+
+  double MaximumForce;
+  double LinearizationRadius;
+  double ServoRate;
+
+  vtkVRPNForceDeviceInternals* Internals;
+
+  // Description:
+  // Evaluate the force field and constraint and send the result
+  void ServoStep();
+
+  //BTX
+  static VTK_THREAD_RETURN_TYPE ServoThread(void* arg);
+  //ETX
+
+private:
+  vtkVRPNForceDevice(const vtkVRPNForceDevice&);  // Not implemented.
+  void operator=(const vtkVRPNForceDevice&);  // Not implemented.
+};
+
+#endif
@@ -16,35 +16,57 @@
 
 #include "vtkVRPNTracker.h"
 
+#include "vtkDeviceStateStream.h"
+#include "vtkDoubleArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkTimeStamp.h"
 #include "vtkstd/vector"
 
 #include <vrpn_Tracker.h>
 
-// Structure to hold tracker information
-struct TrackerInformation 
+// Tracker information for all sensors, stored as one array per quantity
+// so the transformation pass runs over contiguous memory
+class vtkVRPNTrackerInternals
 {
-  double Position[3];
-  double Rotation[4];
+public:
+  // Transformed poses, in room space
+  vtkstd::vector<double> Position;
+  vtkstd::vector<double> Rotation;
 
-  double Velocity[3];
-  double VelocityRotation[4];
-  double VelocityRotationDelta;
+  vtkstd::vector<double> Velocity;
+  vtkstd::vector<double> VelocityRotation;
+  vtkstd::vector<double> VelocityRotationDelta;
 
-  double Acceleration[3];
-  double AccelerationRotation[4];
-  double AccelerationRotationDelta;
+  vtkstd::vector<double> Acceleration;
+  vtkstd::vector<double> AccelerationRotation;
+  vtkstd::vector<double> AccelerationRotationDelta;
 
   // Unit to sensor transformations.  Need one per sensor.
-  double Unit2SensorTranslation[3];
-  double Unit2SensorRotation[3];
-};
-
-class vtkVRPNTrackerInternals
-{
-public:
-  vtkstd::vector<TrackerInformation> Sensors;
+  vtkstd::vector<double> Unit2SensorTranslation;
+  vtkstd::vector<double> Unit2SensorRotation;
+
+  // Poses as reported, in tracker space, waiting to be transformed
+  vtkstd::vector<double> ReportPosition;
+  vtkstd::vector<double> ReportRotation;
+  vtkstd::vector<char> ReportPending;
+  int NumberOfPendingReports;
+
+  // Cached calibration.  Tracker2Room is a scaled rotation matrix and 
+  // translation, Unit2Sensor a rotation matrix per sensor.
+  double Tracker2RoomMatrix[3][3];
+  double Tracker2RoomRotationMatrix[3][3];
+  vtkstd::vector<double> Unit2SensorMatrix;
+  vtkTimeStamp CalibrationTime;
+
+  // Arrays wrapping Position and Rotation
+  vtkDoubleArray* PositionArray;
+  vtkDoubleArray* RotationArray;
+
+  // The tracker, for counting reports
+  vtkVRPNTracker* Tracker;
+
+  int GetNumberOfSensors() { return static_cast<int>(this->ReportPending.size()); }
 };
 
 // Callbacks
@@ -52,6 +74,42 @@ static void VRPN_CALLBACK HandlePosition(void* userData, const vrpn_TRACKERCB t)
 static void VRPN_CALLBACK HandleVelocity(void* userData, const vrpn_TRACKERVELCB t);
 static void VRPN_CALLBACK HandleAcceleration(void* userData, const vrpn_TRACKERACCCB t);
 
+// Copy n values into an array of n-vectors, returning whether any changed
+static inline bool SetVector(vtkstd::vector<double>& array, int n, int index, const double* value)
+{
+  bool changed = false;
+  for (int i = 0; i < n; i++) 
+    {
+    if (array[index * n + i] != value[i]) changed = true;
+    array[index * n + i] = value[i];
+    }
+
+  return changed;
+}
+
+// Point an array at the storage for an array of n-vectors, if it has moved
+static void WrapVector(vtkDoubleArray* data, vtkstd::vector<double>& array, int n)
+{
+  double* storage = array.empty() ? NULL : &array[0];
+  vtkIdType size = static_cast<vtkIdType>(array.size());
+
+  if (data->GetPointer(0) != storage || data->GetSize() != size)
+    {
+    data->SetNumberOfComponents(n);
+    data->SetArray(storage, size, 1);
+    }
+
+  // The storage is written directly, so the array can't tell it changed
+  data->Modified();
+}
+
+// Convert from vrpn quaternion (x, y, z, w) to vtk quaternion (w, x, y, z)
+static inline bool SetQuaternion(vtkstd::vector<double>& array, int index, const double* vrpnQuat)
+{
+  double vtkQuat[4] = { vrpnQuat[3], vrpnQuat[0], vrpnQuat[1], vrpnQuat[2] };
+  return SetVector(array, 4, index, vtkQuat);
+}
+
 vtkCxxRevisionMacro(vtkVRPNTracker, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkVRPNTracker);
 
@@ -59,11 +117,18 @@ vtkStandardNewMacro(vtkVRPNTracker);
 vtkVRPNTracker::vtkVRPNTracker() 
 {
   this->Internals = new vtkVRPNTrackerInternals();
+  this->Internals->Tracker = this;
+  this->Internals->NumberOfPendingReports = 0;
+  this->Internals->PositionArray = vtkDoubleArray::New();
+  this->Internals->PositionArray->SetName("Position");
+  this->Internals->RotationArray = vtkDoubleArray::New();
+  this->Internals->RotationArray->SetName("Rotation");
 
   this->Tracker = NULL;
 
   this->SetTracker2RoomTranslation(0.0, 0.0, 0.0);
   this->SetTracker2RoomRotation(1.0, 0.0, 0.0, 0.0);
+  this->SetTracker2RoomScale(1.0);
 
   this->SetNumberOfSensors(1);
 }
@@ -71,28 +136,27 @@ vtkVRPNTracker::vtkVRPNTracker()
 //----------------------------------------------------------------------------
 vtkVRPNTracker::~vtkVRPNTracker() 
 {
-  if (this->Tracker) delete this->Tracker;
+  // Initialize() may still be running on the background thread
+  this->JoinInitializeThread();
+
+  this->ReleaseRemote();
+
+  this->Internals->PositionArray->Delete();
+  this->Internals->RotationArray->Delete();
 
   delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
-int vtkVRPNTracker::Initialize() 
+int vtkVRPNTracker::CreateRemote() 
 {
-  // Check that the device name is set
-  if (this->DeviceName == NULL) 
-    {
-    vtkErrorMacro(<<"DeviceName not set.");
-    return 0;
-    }
-
   // Create the VRPN tracker remote 
-  this->Tracker = new vrpn_Tracker_Remote(this->DeviceName);
+  this->Tracker = new vrpn_Tracker_Remote(this->DeviceName, this->Connection);
 
   // Set up the tracker callbacks
-  if (this->Tracker->register_change_handler(this, HandlePosition) == -1 ||
-      this->Tracker->register_change_handler(this, HandleVelocity) == -1 ||
-      this->Tracker->register_change_handler(this, HandleAcceleration) == -1)
+  if (this->Tracker->register_change_handler(this->Internals, HandlePosition) == -1 ||
+      this->Tracker->register_change_handler(this->Internals, HandleVelocity) == -1 ||
+      this->Tracker->register_change_handler(this->Internals, HandleAcceleration) == -1)
     {
     vtkErrorMacro(<<"Can't register callback.");
     return 0;
@@ -101,31 +165,226 @@ int vtkVRPNTracker::Initialize()
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkVRPNTracker::DeleteRemote() 
+{
+  if (this->Tracker) delete this->Tracker;
+  this->Tracker = NULL;
+}
+
+//----------------------------------------------------------------------------
+vrpn_BaseClass* vtkVRPNTracker::GetRemote() 
+{
+  return this->Tracker;
+}
+
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::Update() 
 {
-  if (this->Tracker)
-    {
-    this->Tracker->mainloop();
-    }
+  this->Superclass::Update();
+
+  this->TransformReports();
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::InvokeInteractionEvent() 
 {
   if (this->Tracker)
+    {
+    // Pick up reports received since Update(), e.g. when another device
+    // pumped the shared connection after this one updated
+    this->TransformReports();
+    }
+
+  if (this->Tracker || this->Replica)
     {
     // XXX: Should there be a flag to check for new data?
-    this->InvokeEvent(vtkVRPNDevice::TrackerEvent);
+    this->DispatchInteractionEvent(vtkVRPNDevice::TrackerEvent);
     }
 }
 
 //----------------------------------------------------------------------------
-void vtkVRPNTracker::SetNumberOfSensors(int num) 
+void vtkVRPNTracker::WriteState(vtkDeviceStateStream* stream) 
+{
+  vtkVRPNTrackerInternals* internals = this->Internals;
+  int n = internals->GetNumberOfSensors();
+
+  stream->WriteInt(n);
+  stream->WritePositions(&internals->Position[0], n * 3);
+  stream->WriteRotations(&internals->Rotation[0], n * 4);
+  stream->WritePositions(&internals->Velocity[0], n * 3);
+  stream->WriteRotations(&internals->VelocityRotation[0], n * 4);
+  stream->WriteDoubles(&internals->VelocityRotationDelta[0], n);
+  stream->WritePositions(&internals->Acceleration[0], n * 3);
+  stream->WriteRotations(&internals->AccelerationRotation[0], n * 4);
+  stream->WriteDoubles(&internals->AccelerationRotationDelta[0], n);
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTracker::ReadState(vtkDeviceStateStream* stream) 
+{
+  int n = stream->ReadInt();
+  if (stream->GetError() || n <= 0) return;
+
+  if (n != this->GetNumberOfSensors()) this->SetNumberOfSensors(n);
+
+  vtkVRPNTrackerInternals* internals = this->Internals;
+  stream->ReadPositions(&internals->Position[0], n * 3);
+  stream->ReadRotations(&internals->Rotation[0], n * 4);
+  stream->ReadPositions(&internals->Velocity[0], n * 3);
+  stream->ReadRotations(&internals->VelocityRotation[0], n * 4);
+  stream->ReadDoubles(&internals->VelocityRotationDelta[0], n);
+  stream->ReadPositions(&internals->Acceleration[0], n * 3);
+  stream->ReadRotations(&internals->AccelerationRotation[0], n * 4);
+  stream->ReadDoubles(&internals->AccelerationRotationDelta[0], n);
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTracker::UpdateCalibration() 
+{
+  if (this->Internals->CalibrationTime > this->GetMTime()) return;
+
+  vtkVRPNTrackerInternals* internals = this->Internals;
+
+  // Tracker to room
+  vtkMath::QuaternionToMatrix3x3(this->Tracker2RoomRotation, internals->Tracker2RoomRotationMatrix);
+  for (int i = 0; i < 3; i++)
+    {
+    for (int j = 0; j < 3; j++)
+      {
+      internals->Tracker2RoomMatrix[i][j] = 
+        this->Tracker2RoomScale * internals->Tracker2RoomRotationMatrix[i][j];
+      }
+    }
+
+  // Unit to sensor
+  int numSensors = internals->GetNumberOfSensors();
+  for (int s = 0; s < numSensors; s++)
+    {
+    double m[3][3];
+    vtkMath::QuaternionToMatrix3x3(&internals->Unit2SensorRotation[s * 4], m);
+    for (int i = 0; i < 3; i++)
+      {
+      for (int j = 0; j < 3; j++)
+        {
+        internals->Unit2SensorMatrix[s * 9 + i * 3 + j] = m[i][j];
+        }
+      }
+    }
+
+  internals->CalibrationTime.Modified();
+
+  // Retransform the latest reports
+  for (int s = 0; s < numSensors; s++)
+    {
+    internals->ReportPending[s] = 1;
+    }
+  internals->NumberOfPendingReports = numSensors;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTracker::TransformReports() 
 {
-  int currentNum = this->Internals->Sensors.size();
+  // Callbacks may be running from another device pumping the connection
+  this->LockConnection();
+
+  this->UpdateCalibration();
+
+  vtkVRPNTrackerInternals* internals = this->Internals;
+
+  if (internals->NumberOfPendingReports == 0)
+    {
+    this->UnlockConnection();
+    return;
+    }
+
+  const double (*t2r)[3] = internals->Tracker2RoomMatrix;
+  const double (*t2rRot)[3] = internals->Tracker2RoomRotationMatrix;
+  const double* t2rTrans = this->Tracker2RoomTranslation;
+
+  int numSensors = internals->GetNumberOfSensors();
+  for (int s = 0; s < numSensors; s++)
+    {
+    if (!internals->ReportPending[s]) continue;
+
+    const double* reportPos = &internals->ReportPosition[s * 3];
+    const double* u2sTrans = &internals->Unit2SensorTranslation[s * 3];
+    const double* u2sRot = &internals->Unit2SensorMatrix[s * 9];
+    double* pos = &internals->Position[s * 3];
+
+    double sensorRot[3][3];
+    vtkMath::QuaternionToMatrix3x3(&internals->ReportRotation[s * 4], sensorRot);
+
+    // Position of the unit in tracker space
+    double unitPos[3];
+    for (int i = 0; i < 3; i++)
+      {
+      unitPos[i] = reportPos[i] + 
+                   sensorRot[i][0] * u2sTrans[0] + 
+                   sensorRot[i][1] * u2sTrans[1] + 
+                   sensorRot[i][2] * u2sTrans[2];
+      }
+
+    // Position in room space
+    for (int i = 0; i < 3; i++)
+      {
+      pos[i] = t2r[i][0] * unitPos[0] + 
+               t2r[i][1] * unitPos[1] + 
+               t2r[i][2] * unitPos[2] + t2rTrans[i];
+      }
+
+    // Rotation in room space: tracker to room * sensor * unit to sensor
+    double rot[3][3];
+    double temp[3][3];
+    for (int i = 0; i < 3; i++)
+      {
+      for (int j = 0; j < 3; j++)
+        {
+        temp[i][j] = sensorRot[i][0] * u2sRot[0 * 3 + j] + 
+                     sensorRot[i][1] * u2sRot[1 * 3 + j] + 
+                     sensorRot[i][2] * u2sRot[2 * 3 + j];
+        }
+      }
+    for (int i = 0; i < 3; i++)
+      {
+      for (int j = 0; j < 3; j++)
+        {
+        rot[i][j] = t2rRot[i][0] * temp[0][j] + 
+                    t2rRot[i][1] * temp[1][j] + 
+                    t2rRot[i][2] * temp[2][j];
+        }
+      }
+    vtkMath::Matrix3x3ToQuaternion(rot, &internals->Rotation[s * 4]);
+
+    internals->ReportPending[s] = 0;
+    }
+
+  internals->NumberOfPendingReports = 0;
+
+  this->UnlockConnection();
+}
 
-  this->Internals->Sensors.resize(num);
+//----------------------------------------------------------------------------
+void vtkVRPNTracker::SetNumberOfSensors(int num) 
+{
+  vtkVRPNTrackerInternals* internals = this->Internals;
+
+  int currentNum = internals->GetNumberOfSensors();
+
+  internals->Position.resize(num * 3);
+  internals->Rotation.resize(num * 4);
+  internals->Velocity.resize(num * 3);
+  internals->VelocityRotation.resize(num * 4);
+  internals->VelocityRotationDelta.resize(num);
+  internals->Acceleration.resize(num * 3);
+  internals->AccelerationRotation.resize(num * 4);
+  internals->AccelerationRotationDelta.resize(num);
+  internals->Unit2SensorTranslation.resize(num * 3);
+  internals->Unit2SensorRotation.resize(num * 4);
+  internals->Unit2SensorMatrix.resize(num * 9);
+  internals->ReportPosition.resize(num * 3);
+  internals->ReportRotation.resize(num * 4);
+  internals->ReportPending.resize(num);
 
   double identityVector[3] = { 0.0, 0.0, 0.0 };
   double identityQuaternion[4] = { 1.0, 0.0, 0.0, 0.0 };
@@ -145,247 +404,214 @@ void vtkVRPNTracker::SetNumberOfSensors(int num)
 
     this->SetUnit2SensorTranslation(identityVector, i);
     this->SetUnit2SensorRotation(identityQuaternion, i);
+
+    SetVector(internals->ReportPosition, 3, i, identityVector);
+    SetVector(internals->ReportRotation, 4, i, identityQuaternion);
+    internals->ReportPending[i] = 0;
     }
+
+  // Recount, in case pending sensors were removed
+  internals->NumberOfPendingReports = 0;
+  for (int i = 0; i < num; i++)
+    {
+    internals->NumberOfPendingReports += internals->ReportPending[i];
+    }
+
+  // Arrays handed out earlier must not keep pointing at the old storage
+  WrapVector(internals->PositionArray, internals->Position, 3);
+  WrapVector(internals->RotationArray, internals->Rotation, 4);
 }
 
 //----------------------------------------------------------------------------
 int vtkVRPNTracker::GetNumberOfSensors() 
 {
-  return this->Internals->Sensors.size();
+  return this->Internals->GetNumberOfSensors();
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetPosition(double* position, int sensor)
 {
-  for (int i = 0; i < 3; i++)
-    {
-    this->Internals->Sensors[sensor].Position[i] = position[i];
-    }
+  SetVector(this->Internals->Position, 3, sensor, position);
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetPosition(int sensor)
 {
-  return this->Internals->Sensors[sensor].Position;
+  return &this->Internals->Position[sensor * 3];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetRotation(double* rotation, int sensor)
 {
-  for (int i = 0; i < 4; i++)
-    {
-    this->Internals->Sensors[sensor].Rotation[i] = rotation[i];
-    }
+  SetVector(this->Internals->Rotation, 4, sensor, rotation);
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetRotation(int sensor)
 {
-  return this->Internals->Sensors[sensor].Rotation;
+  return &this->Internals->Rotation[sensor * 4];
+}
+
+//----------------------------------------------------------------------------
+vtkDoubleArray* vtkVRPNTracker::GetPositionArray()
+{
+  WrapVector(this->Internals->PositionArray, this->Internals->Position, 3);
+  return this->Internals->PositionArray;
+}
+
+//----------------------------------------------------------------------------
+vtkDoubleArray* vtkVRPNTracker::GetRotationArray()
+{
+  WrapVector(this->Internals->RotationArray, this->Internals->Rotation, 4);
+  return this->Internals->RotationArray;
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetVelocity(double* velocity, int sensor)
 {
-  for (int i = 0; i < 3; i++)
-    {
-    this->Internals->Sensors[sensor].Velocity[i] = velocity[i];
-    }
+  SetVector(this->Internals->Velocity, 3, sensor, velocity);
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetVelocity(int sensor)
 {
-  return this->Internals->Sensors[sensor].Velocity;
+  return &this->Internals->Velocity[sensor * 3];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetVelocityRotation(double* rotation, int sensor)
 {
-  for (int i = 0; i < 4; i++)
-    {
-    this->Internals->Sensors[sensor].VelocityRotation[i] = rotation[i];
-    }
+  SetVector(this->Internals->VelocityRotation, 4, sensor, rotation);
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetVelocityRotation(int sensor)
 {
-  return this->Internals->Sensors[sensor].Velocity;
+  return &this->Internals->VelocityRotation[sensor * 4];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetVelocityRotationDelta(double delta, int sensor)
 {
-  this->Internals->Sensors[sensor].VelocityRotationDelta = delta;
+  this->Internals->VelocityRotationDelta[sensor] = delta;
 }
 
 //----------------------------------------------------------------------------
 double vtkVRPNTracker::GetVelocityRotationDelta(int sensor)
 {
-  return this->Internals->Sensors[sensor].VelocityRotationDelta;
+  return this->Internals->VelocityRotationDelta[sensor];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetAcceleration(double* acceleration, int sensor)
 {
-  for (int i = 0; i < 3; i++)
-    {
-    this->Internals->Sensors[sensor].Acceleration[i] = acceleration[i];
-    }
+  SetVector(this->Internals->Acceleration, 3, sensor, acceleration);
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetAcceleration(int sensor)
 {
-  return this->Internals->Sensors[sensor].Acceleration;
+  return &this->Internals->Acceleration[sensor * 3];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetAccelerationRotation(double* rotation, int sensor)
 {
-  for (int i = 0; i < 4; i++)
-    {
-    this->Internals->Sensors[sensor].AccelerationRotation[i] = rotation[i];
-    }
+  SetVector(this->Internals->AccelerationRotation, 4, sensor, rotation);
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetAccelerationRotation(int sensor)
 {
-  return this->Internals->Sensors[sensor].Acceleration;
+  return &this->Internals->AccelerationRotation[sensor * 4];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetAccelerationRotationDelta(double delta, int sensor)
 {
-  this->Internals->Sensors[sensor].AccelerationRotationDelta = delta;
+  this->Internals->AccelerationRotationDelta[sensor] = delta;
 }
 
 //----------------------------------------------------------------------------
 double vtkVRPNTracker::GetAccelerationRotationDelta(int sensor)
 {
-  return this->Internals->Sensors[sensor].AccelerationRotationDelta;
+  return this->Internals->AccelerationRotationDelta[sensor];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetUnit2SensorTranslation(double* translation, int sensor)
 {
-  for (int i = 0; i < 3; i++)
-    {
-    this->Internals->Sensors[sensor].Unit2SensorTranslation[i] = translation[i];
-    }
+  SetVector(this->Internals->Unit2SensorTranslation, 3, sensor, translation);
+
+  // Update the cached calibration
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetUnit2SensorTranslation(int sensor)
 {
-  return this->Internals->Sensors[sensor].Unit2SensorTranslation;
+  return &this->Internals->Unit2SensorTranslation[sensor * 3];
 }
 
 //----------------------------------------------------------------------------
 void vtkVRPNTracker::SetUnit2SensorRotation(double* rotation, int sensor)
 {
-  for (int i = 0; i < 4; i++)
-    {
-    this->Internals->Sensors[sensor].Unit2SensorRotation[i] = rotation[i];
-    }
+  SetVector(this->Internals->Unit2SensorRotation, 4, sensor, rotation);
+
+  // Update the cached calibration
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
 double* vtkVRPNTracker::GetUnit2SensorRotation(int sensor)
 {
-  return this->Internals->Sensors[sensor].Unit2SensorRotation;
+  return &this->Internals->Unit2SensorRotation[sensor * 4];
 }
 
 //----------------------------------------------------------------------------
 void VRPN_CALLBACK HandlePosition(void* userData, const vrpn_TRACKERCB t) {
-  vtkVRPNTracker* tracker = static_cast<vtkVRPNTracker*>(userData);
+  vtkVRPNTrackerInternals* internals = static_cast<vtkVRPNTrackerInternals*>(userData);
 
-  if (t.sensor < tracker->GetNumberOfSensors()) 
+  if (t.sensor < internals->GetNumberOfSensors()) 
     {
-    // Transform the position
-    double pos[3];
-    double t2wTrans[3];
-    tracker->GetTracker2RoomTranslation(t2wTrans);
-    for (int i = 0; i < 3; i++) {
-        pos[i] = t.pos[i] + t2wTrans[i];
-    }
-
-    // Set the position for this sensor
-    tracker->SetPosition(pos, t.sensor);
-
-    // Convert from vrpn quaternion (x, y, z, w) to vtk quaternion (w, x, y, z)
-    double vtkQuat[4];
-    vtkQuat[0] = t.quat[3];
-    vtkQuat[1] = t.quat[0];
-    vtkQuat[2] = t.quat[1];
-    vtkQuat[3] = t.quat[2];
-    
-    // Transform the rotation via matrix operations.  
-    // Would be nice if VTK had quaternion operations instead...
-    double rot[3][3];
-    vtkMath::QuaternionToMatrix3x3(vtkQuat, rot);
-
-    double t2wRot[3][3];
-    vtkMath::QuaternionToMatrix3x3(tracker->GetTracker2RoomRotation(), t2wRot);
-
-    vtkMath::Multiply3x3(rot, t2wRot, rot);
-
-    vtkMath::Matrix3x3ToQuaternion(rot, vtkQuat);
-
-    // Set the rotation for this sensor
-    tracker->SetRotation(vtkQuat, t.sensor);
+    // Store the report, to be transformed with the others in TransformReports()
+    bool moved = SetVector(internals->ReportPosition, 3, t.sensor, t.pos);
+    if (SetQuaternion(internals->ReportRotation, t.sensor, t.quat)) moved = true;
+
+    if (!internals->ReportPending[t.sensor])
+      {
+      internals->ReportPending[t.sensor] = 1;
+      internals->NumberOfPendingReports++;
+      }
+
+    // Trackers stream poses while still, so only count poses that move
+    if (moved) internals->Tracker->ReportReceived();
     }
 }
 
 //----------------------------------------------------------------------------
 void VRPN_CALLBACK HandleVelocity(void* userData, const vrpn_TRACKERVELCB t) {
-  vtkVRPNTracker* tracker = static_cast<vtkVRPNTracker*>(userData);
+  vtkVRPNTrackerInternals* internals = static_cast<vtkVRPNTrackerInternals*>(userData);
 
-  if (t.sensor < tracker->GetNumberOfSensors()) 
+  if (t.sensor < internals->GetNumberOfSensors()) 
     {
-    // Set the velocity for this sensor
-    tracker->SetVelocity((double*)t.vel, t.sensor);
-    
-    // Convert from vrpn quaternion (x, y, z, w) to vtk quaternion (w, x, y, z)
-    double vtkQuat[4];
-    vtkQuat[0] = t.vel_quat[3];
-    vtkQuat[1] = t.vel_quat[0];
-    vtkQuat[2] = t.vel_quat[1];
-    vtkQuat[3] = t.vel_quat[2];
-    tracker->SetVelocityRotation(vtkQuat, t.sensor);
-
-    // Set the velocity rotation for this sensor
-    tracker->SetVelocityRotation(vtkQuat, t.sensor);
-    
-    // Set the velocity rotation delta for this sensor
-    tracker->SetVelocityRotationDelta(t.vel_quat_dt, t.sensor);
+    // Set the velocity, velocity rotation and velocity rotation delta for this sensor
+    SetVector(internals->Velocity, 3, t.sensor, t.vel);
+    SetQuaternion(internals->VelocityRotation, t.sensor, t.vel_quat);
+    internals->VelocityRotationDelta[t.sensor] = t.vel_quat_dt;
     }
 }
 
 //----------------------------------------------------------------------------
 void VRPN_CALLBACK HandleAcceleration(void* userData, const vrpn_TRACKERACCCB t) {
-  vtkVRPNTracker* tracker = static_cast<vtkVRPNTracker*>(userData);
+  vtkVRPNTrackerInternals* internals = static_cast<vtkVRPNTrackerInternals*>(userData);
 
-  if (t.sensor < tracker->GetNumberOfSensors()) 
+  if (t.sensor < internals->GetNumberOfSensors()) 
     {
-    // Set the acceleration for this sensor
-    tracker->SetAcceleration((double*)t.acc, t.sensor);
-    
-    // Convert from vrpn quaternion (x, y, z, w) to vtk quaternion (w, x, y, z)
-    double vtkQuat[4];
-    vtkQuat[0] = t.acc_quat[3];
-    vtkQuat[1] = t.acc_quat[0];
-    vtkQuat[2] = t.acc_quat[1];
-    vtkQuat[3] = t.acc_quat[2];
-    tracker->SetAccelerationRotation(vtkQuat, t.sensor);
-
-    // Set the acceleration rotation for this sensor
-    tracker->SetAccelerationRotation(vtkQuat, t.sensor);
-
-    // Set the acceleration rotation delta for this sensor
-    tracker->SetAccelerationRotationDelta(t.acc_quat_dt, t.sensor);
+    // Set the acceleration, acceleration rotation and acceleration rotation delta for this sensor
+    SetVector(internals->Acceleration, 3, t.sensor, t.acc);
+    SetQuaternion(internals->AccelerationRotation, t.sensor, t.acc_quat);
+    internals->AccelerationRotationDelta[t.sensor] = t.acc_quat_dt;
     }
 }
 
@@ -394,33 +620,32 @@ void vtkVRPNTracker::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
-  os << indent << "Tracker: "; Tracker->print_latest_report();
+  os << indent << "Tracker: "; 
+  if (this->Tracker) this->Tracker->print_latest_report();
+  else os << "(none)\n";
+
+  os << indent << "Tracker2RoomScale: " << this->Tracker2RoomScale << "\n";
 
   os << indent << "Sensors:" << endl;
-  for (unsigned int i = 0; i < this->Internals->Sensors.size(); i++)
+  for (int i = 0; i < this->GetNumberOfSensors(); i++)
     {
-    os << indent << indent << "Position: (" << this->Internals->Sensors[i].Position[0]
-                 << ", " << this->Internals->Sensors[i].Position[1]
-                 << ", " << this->Internals->Sensors[i].Position[2] << ")\n";
-    os << indent << indent << "Rotation: (" << this->Internals->Sensors[i].Rotation[0]
-                 << ", " << this->Internals->Sensors[i].Rotation[1]
-                 << ", " << this->Internals->Sensors[i].Rotation[2]
-                 << ", " << this->Internals->Sensors[i].Rotation[3] << ")\n";
-    os << indent << indent << "Velocity: (" << this->Internals->Sensors[i].Velocity[0]
-                 << ", " << this->Internals->Sensors[i].Velocity[1]
-                 << ", " << this->Internals->Sensors[i].Velocity[2] << ")\n";    
-    os << indent << indent << "Velocity Rotation: (" << this->Internals->Sensors[i].VelocityRotation[0]
-                 << ", " << this->Internals->Sensors[i].VelocityRotation[1]
-                 << ", " << this->Internals->Sensors[i].VelocityRotation[2] 
-                 << ", " << this->Internals->Sensors[i].VelocityRotation[3] << ")\n";   
-    os << indent << indent << "VelocityRotationDelta: " << this->Internals->Sensors[i].VelocityRotationDelta << "\n";    
-    os << indent << indent << "Acceleration: (" << this->Internals->Sensors[i].Acceleration[0]
-                 << ", " << this->Internals->Sensors[i].Acceleration[1]
-                 << ", " << this->Internals->Sensors[i].Acceleration[2] << ")\n";    
-    os << indent << indent << "Acceleration Rotation: (" << this->Internals->Sensors[i].AccelerationRotation[0]
-                 << ", " << this->Internals->Sensors[i].AccelerationRotation[1]
-                 << ", " << this->Internals->Sensors[i].AccelerationRotation[2]
-                 << ", " << this->Internals->Sensors[i].AccelerationRotation[3] << ")\n";   
-    os << indent << indent << "AccelerationRotationDelta: " << this->Internals->Sensors[i].AccelerationRotationDelta << "\n";   
+    double* v = this->GetPosition(i);
+    os << indent << indent << "Position: (" << v[0] << ", " << v[1] << ", " << v[2] << ")\n";
+    v = this->GetRotation(i);
+    os << indent << indent << "Rotation: (" << v[0] << ", " << v[1] << ", " << v[2] << ", " << v[3] << ")\n";
+    v = this->GetVelocity(i);
+    os << indent << indent << "Velocity: (" << v[0] << ", " << v[1] << ", " << v[2] << ")\n";
+    v = this->GetVelocityRotation(i);
+    os << indent << indent << "Velocity Rotation: (" << v[0] << ", " << v[1] << ", " << v[2] << ", " << v[3] << ")\n";
+    os << indent << indent << "VelocityRotationDelta: " << this->GetVelocityRotationDelta(i) << "\n";
+    v = this->GetAcceleration(i);
+    os << indent << indent << "Acceleration: (" << v[0] << ", " << v[1] << ", " << v[2] << ")\n";
+    v = this->GetAccelerationRotation(i);
+    os << indent << indent << "Acceleration Rotation: (" << v[0] << ", " << v[1] << ", " << v[2] << ", " << v[3] << ")\n";
+    os << indent << indent << "AccelerationRotationDelta: " << this->GetAccelerationRotationDelta(i) << "\n";
+    v = this->GetUnit2SensorTranslation(i);
+    os << indent << indent << "Unit2SensorTranslation: (" << v[0] << ", " << v[1] << ", " << v[2] << ")\n";
+    v = this->GetUnit2SensorRotation(i);
+    os << indent << indent << "Unit2SensorRotation: (" << v[0] << ", " << v[1] << ", " << v[2] << ", " << v[3] << ")\n";
     }
 }
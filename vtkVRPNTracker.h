@@ -29,6 +29,7 @@
 
 #include "vtkVRPNDevice.h"
 
+class vtkDoubleArray;
 class vrpn_Tracker_Remote;
 
 // Holds vtkstd member variables, which must be hidden
@@ -42,17 +43,18 @@ public:
   void PrintSelf(ostream&, vtkIndent);
 
   // Description:
-  // Initialize the device
-  virtual int Initialize();
-
-  // Description:
-  // Receive updates from the device
+  // Receive updates from the device and transform them to room space
   virtual void Update();
 
   // Description:
   // Invoke vrpnDevice::TrackerEvent for observers to listen for
   virtual void InvokeInteractionEvent();
 
+  // Description:
+  // Write/read the state received in the last Update()
+  virtual void WriteState(vtkDeviceStateStream*);
+  virtual void ReadState(vtkDeviceStateStream*);
+
   // Description:
   // The number of sensors to use
   virtual void SetNumberOfSensors(int num);
@@ -82,17 +84,31 @@ public:
   void SetAccelerationRotationDelta(double delta, int sensor = 0);
   double GetAccelerationRotationDelta(int sensor = 0);
 
+  // Description:
+  // Get the positions (3 components) and rotations (4 components, as 
+  // quaternions) of all sensors as arrays, one tuple per sensor.  The 
+  // arrays use the tracker's own storage, so they always hold the latest
+  // poses without copying, e.g. for viewing from NumPy.  The arrays are 
+  // re-pointed when the number of sensors changes, e.g. in ReadState() 
+  // on a replica, but raw pointers taken from them must be taken again.
+  vtkDoubleArray* GetPositionArray();
+  vtkDoubleArray* GetRotationArray();
+
   void SetUnit2SensorTranslation(double* translation, int sensor = 0);
   double *GetUnit2SensorTranslation(int sensor = 0);
   void SetUnit2SensorRotation(double* rotation, int sensor = 0);
   double *GetUnit2SensorRotation(int sensor = 0);
 
   // Description:
-  // Transformation from tracker space to room space
+  // Transformation from tracker space to room space.  The scale converts 
+  // tracker units to room units.  Reported positions and rotations are 
+  // transformed by tracker to room * sensor * unit to sensor.
   vtkSetVector3Macro(Tracker2RoomTranslation,double);
   vtkGetVector3Macro(Tracker2RoomTranslation,double);
   vtkSetVector4Macro(Tracker2RoomRotation,double);
   vtkGetVector4Macro(Tracker2RoomRotation,double);
+  vtkSetMacro(Tracker2RoomScale,double);
+  vtkGetMacro(Tracker2RoomScale,double);
 
 protected:
   vtkVRPNTracker();
@@ -100,8 +116,24 @@ protected:
 
   vrpn_Tracker_Remote* Tracker;
 
+  // Description:
+  // Create/delete the VRPN remote
+  virtual int CreateRemote();
+  virtual void DeleteRemote();
+  virtual vrpn_BaseClass* GetRemote();
+
   double Tracker2RoomTranslation[3];
   double Tracker2RoomRotation[4];
+  double Tracker2RoomScale;
+
+  // Description:
+  // Rebuild the cached calibration matrices if the calibration changed
+  void UpdateCalibration();
+
+  // Description:
+  // Transform all reports received since the last call to room space in
+  // one pass
+  void TransformReports();
 
   vtkVRPNTrackerInternals* Internals;
 
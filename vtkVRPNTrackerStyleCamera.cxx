@@ -16,8 +16,8 @@
 
 #include "vtkVRPNTrackerStyleCamera.h"
 
-#include "vtkCallbackCommand.h"
 #include "vtkCamera.h"
+#include "vtkDeviceCamera.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkRenderWindow.h"
@@ -30,6 +30,10 @@ vtkCxxRevisionMacro(vtkVRPNTrackerStyleCamera, "$Revision: 1.0 $");
 //----------------------------------------------------------------------------
 vtkVRPNTrackerStyleCamera::vtkVRPNTrackerStyleCamera() 
 { 
+  this->Fishtank = 0;
+  this->HeadReferencePosition[0] = 0.0;
+  this->HeadReferencePosition[1] = 0.0;
+  this->HeadReferencePosition[2] = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -55,7 +59,7 @@ void vtkVRPNTrackerStyleCamera::SetTracker(vtkVRPNTracker* tracker)
 {  
   if (tracker != NULL) 
     {
-    tracker->AddObserver(vtkVRPNDevice::TrackerEvent, this->DeviceCallback);
+    tracker->AddDeviceInteractorStyle(this, vtkInteractionDevice::EventBit(vtkVRPNDevice::TrackerEvent));
     }
 } 
 
@@ -63,37 +67,47 @@ void vtkVRPNTrackerStyleCamera::SetTracker(vtkVRPNTracker* tracker)
 void vtkVRPNTrackerStyleCamera::OnTracker(vtkVRPNTracker* tracker)
 {
   vtkCamera* camera = this->Renderer->GetActiveCamera();
+  vtkDeviceCamera* deviceCamera = vtkDeviceCamera::SafeDownCast(camera);
 
-  // Get the transformed position
-  double position[3];
-  for (int i = 0; i < 3; i++) 
+  // The tracker has already transformed the pose to room space
+  double* position = tracker->GetPosition();
+  this->InteractAt(position);
+
+  if (this->Fishtank && deviceCamera)
     {
-    position[i] = tracker->GetPosition()[i] + tracker->GetTracker2RoomTranslation()[i];
+    double offset[3];
+    for (int i = 0; i < 3; i++) offset[i] = position[i] - this->HeadReferencePosition[i];
+    deviceCamera->SetHeadOffset(offset);
+
+    this->Renderer->ResetCameraClippingRange();
+    return;
     }
 
   // Get the rotation matrix
   double rotation[3][3];
   vtkMath::QuaternionToMatrix3x3(tracker->GetRotation(), rotation);
 
-  // Transform the rotation
-  double t2rRotation[3][3];
-  vtkMath::QuaternionToMatrix3x3(tracker->GetTracker2RoomRotation(), t2rRotation);
-  vtkMath::Multiply3x3(rotation, t2rRotation, rotation);
-
   // Calculate the view direction
   double forward[3] = { 0.0, 0.0, 1.0 };
   vtkMath::Multiply3x3(rotation, forward, forward);
-  for (int i = 0; i < 3; i++) forward[i] += tracker->GetPosition()[i];
+  for (int i = 0; i < 3; i++) forward[i] += position[i];
 
   // Calculate the up vector
   double up[3] = { 0.0, 1.0, 0.0 };
   vtkMath::Multiply3x3(rotation, up, up);
 
   // Set camera parameters
-  camera->SetPosition(position);
-  camera->SetFocalPoint(forward);
-  camera->SetViewUp(up);
-  camera->Modified();
+  if (deviceCamera)
+    {
+    // Recomputes the camera's matrices once
+    deviceCamera->SetPose(position, forward, up);
+    }
+  else
+    {
+    camera->SetPosition(position);
+    camera->SetFocalPoint(forward);
+    camera->SetViewUp(up);
+    }
 
   // Render
   this->Renderer->ResetCameraClippingRange();
@@ -104,4 +118,8 @@ void vtkVRPNTrackerStyleCamera::OnTracker(vtkVRPNTracker* tracker)
 void vtkVRPNTrackerStyleCamera::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Fishtank: " << this->Fishtank << "\n";
+  os << indent << "HeadReferencePosition: (" << this->HeadReferencePosition[0] << ", " 
+     << this->HeadReferencePosition[1] << ", " << this->HeadReferencePosition[2] << ")\n";
 }
\ No newline at end of file
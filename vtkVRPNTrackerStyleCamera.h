@@ -46,12 +46,27 @@ public:
   // Set the tracker receiving events from
   void SetTracker(vtkVRPNTracker*);
 
+  // Description:
+  // Fishtank mode keeps the camera at a reference pose and moves the eye
+  // by the offset of the tracker from HeadReferencePosition.  The room 
+  // space x, y and z axes should be aligned with the screen's right, up 
+  // and out directions.  Requires the renderer's active camera to be a 
+  // vtkDeviceCamera, and is ignored otherwise.
+  vtkSetMacro(Fishtank,int);
+  vtkGetMacro(Fishtank,int);
+  vtkBooleanMacro(Fishtank,int);
+  vtkSetVector3Macro(HeadReferencePosition,double);
+  vtkGetVector3Macro(HeadReferencePosition,double);
+
 protected:
   vtkVRPNTrackerStyleCamera();
   ~vtkVRPNTrackerStyleCamera();
 
   virtual void OnTracker(vtkVRPNTracker*);
 
+  int Fishtank;
+  double HeadReferencePosition[3];
+
 private:
   vtkVRPNTrackerStyleCamera(const vtkVRPNTrackerStyleCamera&);  // Not implemented.
   void operator=(const vtkVRPNTrackerStyleCamera&);  // Not implemented.
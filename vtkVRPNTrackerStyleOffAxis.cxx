@@ -0,0 +1,308 @@
+/*=========================================================================
+
+  Name:        vtkVRPNTrackerStyleOffAxis.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkVRPNTrackerStyleOffAxis.h"
+
+#include "vtkCamera.h"
+#include "vtkDeviceCamera.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkTransform.h"
+#include "vtkVRPNTracker.h"
+#include "vtkstd/vector"
+
+// Screen geometry that doesn't depend on the head position
+struct vtkVRPNTrackerStyleOffAxisScreen
+{
+  vtkRenderer* Renderer;
+
+  // Lower-left corner, and unit right, up and normal vectors
+  double Origin[3];
+  double Right[3];
+  double Up[3];
+  double Normal[3];
+
+  double Width;
+  double Height;
+
+  // Scales the frustum horizontally when the renderer's aspect doesn't
+  // match the screen's
+  vtkTransform* AspectTransform;
+
+  // The camera the aspect transform is installed on, and the user 
+  // transform it replaced, restored when the screen is removed
+  vtkCamera* Camera;
+  vtkHomogeneousTransform* PreviousUserTransform;
+};
+
+// Put back the user transform the aspect transform replaced, unless 
+// someone else has replaced it since
+static void RestoreUserTransform(vtkVRPNTrackerStyleOffAxisScreen& screen)
+{
+  if (screen.Camera == NULL) return;
+
+  if (screen.Camera->GetUserTransform() == screen.AspectTransform)
+    {
+    screen.Camera->SetUserTransform(screen.PreviousUserTransform);
+    }
+
+  if (screen.PreviousUserTransform) screen.PreviousUserTransform->UnRegister(NULL);
+  screen.PreviousUserTransform = NULL;
+  screen.Camera->UnRegister(NULL);
+  screen.Camera = NULL;
+}
+
+class vtkVRPNTrackerStyleOffAxisInternals
+{
+public:
+  vtkstd::vector<vtkVRPNTrackerStyleOffAxisScreen> Screens;
+};
+
+vtkStandardNewMacro(vtkVRPNTrackerStyleOffAxis);
+vtkCxxRevisionMacro(vtkVRPNTrackerStyleOffAxis, "$Revision: 1.0 $");
+
+//----------------------------------------------------------------------------
+vtkVRPNTrackerStyleOffAxis::vtkVRPNTrackerStyleOffAxis() 
+{ 
+  this->Internals = new vtkVRPNTrackerStyleOffAxisInternals();
+
+  this->HeadSensor = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkVRPNTrackerStyleOffAxis::~vtkVRPNTrackerStyleOffAxis() 
+{
+  this->RemoveAllScreens();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTrackerStyleOffAxis::OnEvent(vtkObject* caller, unsigned long eid, void* callData) 
+{
+  vtkVRPNTracker* tracker = static_cast<vtkVRPNTracker*>(caller);
+
+  switch(eid)
+    {
+    case vtkVRPNDevice::TrackerEvent:
+      this->OnTracker(tracker);
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTrackerStyleOffAxis::SetTracker(vtkVRPNTracker* tracker)
+{  
+  if (tracker != NULL) 
+    {
+    tracker->AddDeviceInteractorStyle(this, vtkInteractionDevice::EventBit(vtkVRPNDevice::TrackerEvent));
+    }
+} 
+
+//----------------------------------------------------------------------------
+int vtkVRPNTrackerStyleOffAxis::AddScreen(vtkRenderer* renderer, const double lowerLeft[3], 
+                                          const double lowerRight[3], const double upperLeft[3])
+{
+  if (renderer == NULL)
+    {
+    vtkErrorMacro(<<"Renderer not set.");
+    return -1;
+    }
+
+  vtkVRPNTrackerStyleOffAxisScreen screen;
+
+  for (int i = 0; i < 3; i++)
+    {
+    screen.Origin[i] = lowerLeft[i];
+    screen.Right[i] = lowerRight[i] - lowerLeft[i];
+    screen.Up[i] = upperLeft[i] - lowerLeft[i];
+    }
+
+  screen.Width = vtkMath::Normalize(screen.Right);
+  screen.Height = vtkMath::Normalize(screen.Up);
+
+  vtkMath::Cross(screen.Right, screen.Up, screen.Normal);
+  if (screen.Width == 0.0 || screen.Height == 0.0 || 
+      vtkMath::Normalize(screen.Normal) == 0.0)
+    {
+    vtkErrorMacro(<<"Screen corners are degenerate.");
+    return -1;
+    }
+
+  screen.Renderer = renderer;
+  screen.Renderer->Register(this);
+
+  screen.AspectTransform = vtkTransform::New();
+  screen.Camera = NULL;
+  screen.PreviousUserTransform = NULL;
+
+  this->Internals->Screens.push_back(screen);
+
+  return this->Internals->Screens.size() - 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTrackerStyleOffAxis::RemoveAllScreens()
+{
+  for (unsigned int i = 0; i < this->Internals->Screens.size(); i++)
+    {
+    vtkVRPNTrackerStyleOffAxisScreen& screen = this->Internals->Screens[i];
+
+    RestoreUserTransform(screen);
+    screen.Renderer->UnRegister(this);
+    screen.AspectTransform->Delete();
+    }
+
+  this->Internals->Screens.clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkVRPNTrackerStyleOffAxis::GetNumberOfScreens()
+{
+  return this->Internals->Screens.size();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTrackerStyleOffAxis::OnTracker(vtkVRPNTracker* tracker)
+{
+  if (this->HeadSensor >= tracker->GetNumberOfSensors()) return;
+
+  // Evaluate the head pose once for all screens
+  double eye[3];
+  double* position = tracker->GetPosition(this->HeadSensor);
+  for (int i = 0; i < 3; i++) eye[i] = position[i];
+
+  this->InteractAt(eye);
+
+  for (unsigned int i = 0; i < this->Internals->Screens.size(); i++)
+    {
+    this->UpdateScreen(i, eye);
+    }
+
+  // Render() will be called in the interactor
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTrackerStyleOffAxis::SetRenderWindowUpdateRate(double rate)
+{
+  this->Superclass::SetRenderWindowUpdateRate(rate);
+
+  for (unsigned int i = 0; i < this->Internals->Screens.size(); i++)
+    {
+    vtkRenderWindow* window = this->Internals->Screens[i].Renderer->GetRenderWindow();
+    if (window) window->SetDesiredUpdateRate(rate);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTrackerStyleOffAxis::UpdateScreen(int index, const double eye[3])
+{
+  vtkVRPNTrackerStyleOffAxisScreen& screen = this->Internals->Screens[index];
+
+  // Vector from the eye to the lower-left corner, in the screen's basis
+  double toOrigin[3];
+  for (int i = 0; i < 3; i++) toOrigin[i] = screen.Origin[i] - eye[i];
+
+  double left = vtkMath::Dot(toOrigin, screen.Right);
+  double bottom = vtkMath::Dot(toOrigin, screen.Up);
+  double distance = -vtkMath::Dot(toOrigin, screen.Normal);
+
+  // Behind or on the screen plane
+  if (distance <= 0.0) return;
+
+  // Look perpendicular to the screen, from the eye to the screen plane
+  double focalPoint[3];
+  for (int i = 0; i < 3; i++) focalPoint[i] = eye[i] - distance * screen.Normal[i];
+
+  vtkCamera* camera = screen.Renderer->GetActiveCamera();
+  vtkDeviceCamera* deviceCamera = vtkDeviceCamera::SafeDownCast(camera);
+
+  if (camera != screen.Camera)
+    {
+    // Remember the user transform of a new camera before replacing it
+    RestoreUserTransform(screen);
+
+    screen.Camera = camera;
+    screen.Camera->Register(NULL);
+    screen.PreviousUserTransform = camera->GetUserTransform();
+    if (screen.PreviousUserTransform) screen.PreviousUserTransform->Register(NULL);
+    }
+
+  if (deviceCamera)
+    {
+    deviceCamera->SetPose(eye, focalPoint, screen.Up);
+    }
+  else
+    {
+    camera->SetPosition(eye[0], eye[1], eye[2]);
+    camera->SetFocalPoint(focalPoint);
+    camera->SetViewUp(screen.Up[0], screen.Up[1], screen.Up[2]);
+    }
+
+  // The vertical extent of the frustum is given by the view angle, and 
+  // its offset from the view direction by the window center, both 
+  // relative to the half extents at the screen plane.  The horizontal 
+  // extent follows from the renderer's aspect, so scale it to fit the 
+  // screen if the aspects differ.  The camera applies the scale after the
+  // projection, in normalized device coordinates, so the window center is
+  // relative to the renderer's half width, and is then scaled with the 
+  // rest of the frustum.
+  double halfWidth = 0.5 * screen.Width;
+  double halfHeight = 0.5 * screen.Height;
+  double centerX = left + halfWidth;
+  double centerY = bottom + halfHeight;
+
+  double aspect[2];
+  screen.Renderer->ComputeAspect();
+  screen.Renderer->GetAspect(aspect);
+  double rendererHalfWidth = aspect[0] / aspect[1] * halfHeight;
+
+  camera->SetViewAngle(2.0 * atan(halfHeight / distance) * vtkMath::RadiansToDegrees());
+  camera->SetWindowCenter(centerX / rendererHalfWidth, centerY / halfHeight);
+
+  // Identity if the aspects match
+  double scale = rendererHalfWidth / halfWidth;
+  screen.AspectTransform->Identity();
+  screen.AspectTransform->Scale(scale, 1.0, 1.0);
+  if (camera->GetUserTransform() != screen.AspectTransform)
+    {
+    camera->SetUserTransform(screen.AspectTransform);
+    }
+
+  screen.Renderer->ResetCameraClippingRange();
+}
+
+//----------------------------------------------------------------------------
+void vtkVRPNTrackerStyleOffAxis::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "HeadSensor: " << this->HeadSensor << "\n";
+  os << indent << "Screens:\n";
+  for (unsigned int i = 0; i < this->Internals->Screens.size(); i++)
+    {
+    vtkVRPNTrackerStyleOffAxisScreen& screen = this->Internals->Screens[i];
+    os << indent << indent << "Renderer: " << screen.Renderer << "\n";
+    os << indent << indent << "Origin: (" << screen.Origin[0] << ", " 
+       << screen.Origin[1] << ", " << screen.Origin[2] << ")\n";
+    os << indent << indent << "Normal: (" << screen.Normal[0] << ", " 
+       << screen.Normal[1] << ", " << screen.Normal[2] << ")\n";
+    os << indent << indent << "Width: " << screen.Width << "\n";
+    os << indent << indent << "Height: " << screen.Height << "\n";
+    }
+}
@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Name:        vtkVRPNTrackerStyleOffAxis.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+               
+               See included License.txt or 
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkVRPNTrackerStyleOffAxis
+// .SECTION Description
+// vtkVRPNTrackerStyleOffAxis sets up head-tracked, off-axis projections 
+// for fixed physical screens, such as the walls of a CAVE or a fishtank 
+// monitor, based on tracker events generated by devices using the 
+// Virtual Reality Peripheral Network (VRPN: 
+// http://www.cs.unc.edu/Research/vrpn/).  
+//
+// Each screen is defined by its lower-left, lower-right and upper-left 
+// corners in room space, and has its own renderer.  The screen's basis is
+// computed once when it is added.  On each tracker report, the head 
+// position is read once and each renderer's camera is placed at the head,
+// looking perpendicular to its screen, with an asymmetric frustum through
+// the screen's edges.
+//
+// The room space used by the tracker is assumed to be world space.  If 
+// a renderer's camera is a vtkDeviceCamera, its pose is set in one step.
+
+// .SECTION see also
+// vtkVRPNTrackerStyleCamera vtkDeviceCamera
+
+#ifndef __vtkVRPNTrackerStyleOffAxis_h
+#define __vtkVRPNTrackerStyleOffAxis_h
+
+#include "vtkInteractionDeviceConfigure.h"
+
+#include "vtkDeviceInteractorStyle.h"
+
+class vtkVRPNTracker;
+
+// Holds vtkstd member variables, which must be hidden
+class vtkVRPNTrackerStyleOffAxisInternals;
+
+class VTK_INTERACTIONDEVICE_EXPORT vtkVRPNTrackerStyleOffAxis : public vtkDeviceInteractorStyle
+{
+public:
+  static vtkVRPNTrackerStyleOffAxis* New();
+  vtkTypeRevisionMacro(vtkVRPNTrackerStyleOffAxis,vtkDeviceInteractorStyle);
+  void PrintSelf(ostream&, vtkIndent); 
+
+  // Description:
+  // Perform interaction based on an event
+  virtual void OnEvent(vtkObject* caller, unsigned long eid, void* callData);
+
+  // Description:
+  // Set the tracker receiving events from
+  void SetTracker(vtkVRPNTracker*);
+
+  // Description:
+  // Set/get the tracker sensor attached to the head
+  vtkSetMacro(HeadSensor,int);
+  vtkGetMacro(HeadSensor,int);
+
+  // Description:
+  // Add a screen, given its corners in room space, and the renderer 
+  // drawing to it.  Returns the index of the screen, or -1 if the corners
+  // are degenerate.
+  int AddScreen(vtkRenderer* renderer, const double lowerLeft[3], 
+                const double lowerRight[3], const double upperLeft[3]);
+  void RemoveAllScreens();
+  int GetNumberOfScreens();
+
+protected:
+  vtkVRPNTrackerStyleOffAxis();
+  ~vtkVRPNTrackerStyleOffAxis();
+
+  virtual void OnTracker(vtkVRPNTracker*);
+
+  // Description:
+  // Set up the camera for one screen given the eye position
+  void UpdateScreen(int screen, const double eye[3]);
+
+  // Description:
+  // Also set the update rate of the screens' render windows
+  virtual void SetRenderWindowUpdateRate(double rate);
+
+  int HeadSensor;
+
+  vtkVRPNTrackerStyleOffAxisInternals* Internals;
+
+private:
+  vtkVRPNTrackerStyleOffAxis(const vtkVRPNTrackerStyleOffAxis&);  // Not implemented.
+  void operator=(const vtkVRPNTrackerStyleOffAxis&);  // Not implemented.
+};
+
+#endif
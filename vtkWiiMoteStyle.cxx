@@ -16,7 +16,6 @@
 
 #include "vtkWiiMoteStyle.h"
 
-#include "vtkCallbackCommand.h"
 #include "vtkVRPNAnalog.h"
 #include "vtkVRPNAnalogOutput.h"
 #include "vtkVRPNButton.h"
@@ -37,13 +36,32 @@ vtkWiiMoteStyle::~vtkWiiMoteStyle()
   this->SetAnalogOutput(NULL);
 }
 
+//----------------------------------------------------------------------------
+void vtkWiiMoteStyle::OnEvent(vtkObject* caller, unsigned long eid, void* callData) 
+{
+  // Need to initialize both here, as they cannot be initialized in the case statement
+  vtkVRPNAnalog* analog = static_cast<vtkVRPNAnalog*>(caller);
+  vtkVRPNButton* button = static_cast<vtkVRPNButton*>(caller);
+
+  switch(eid)
+    {
+    case vtkVRPNDevice::AnalogEvent:
+      this->OnAnalog(analog);
+      break;
+
+    case vtkVRPNDevice::ButtonEvent:
+      this->OnButton(button);
+      break;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkWiiMoteStyle::SetAnalog(vtkVRPNAnalog* analog)
 {  
   if (analog != NULL) 
     {
     analog->SetNumberOfChannels(16);
-    analog->AddObserver(vtkVRPNDevice::AnalogEvent, this->DeviceCallback);
+    analog->AddDeviceInteractorStyle(this, vtkInteractionDevice::EventBit(vtkVRPNDevice::AnalogEvent));
     }
 } 
 
@@ -53,7 +71,7 @@ void vtkWiiMoteStyle::SetButton(vtkVRPNButton* button)
   if (button != NULL) 
     {
     button->SetNumberOfButtons(16);
-    button->AddObserver(vtkVRPNDevice::ButtonEvent, this->DeviceCallback);
+    button->AddDeviceInteractorStyle(this, vtkInteractionDevice::EventBit(vtkVRPNDevice::ButtonEvent));
     }
 } 
 
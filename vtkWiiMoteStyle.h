@@ -40,6 +40,10 @@ public:
   vtkTypeRevisionMacro(vtkWiiMoteStyle,vtkDeviceInteractorStyle);
   void PrintSelf(ostream&, vtkIndent); 
 
+  // Description:
+  // Perform interaction based on an event
+  virtual void OnEvent(vtkObject* caller, unsigned long eid, void* callData);
+
   // Description:
   // Set the devices to connect to the WiiMote
   void SetAnalog(vtkVRPNAnalog*);
@@ -17,11 +17,13 @@
 #include "vtkWiiMoteStyleCamera.h"
 
 #include "vtkCamera.h"
-#include "vtkInteractorObserver.h"
+#include "vtkDeviceInertia.h"
+#include "vtkDeviceViewTransform.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderer.h"
+#include "vtkTimerLog.h"
 #include "vtkVRPNAnalog.h"
 #include "vtkVRPNAnalogOutput.h"
 #include "vtkVRPNButton.h"
@@ -46,30 +48,17 @@ vtkWiiMoteStyleCamera::vtkWiiMoteStyleCamera()
 
   this->TriggerDown = false;
   this->HomeDown = false;
-}
+  this->PanDown = false;
 
-//----------------------------------------------------------------------------
-vtkWiiMoteStyleCamera::~vtkWiiMoteStyleCamera() 
-{
+  // Speed in pan steps per second
+  this->PanInertia = vtkDeviceInertia::New();
+  this->PanInertia->SetMinimumSpeed(1.0);
 }
 
 //----------------------------------------------------------------------------
-void vtkWiiMoteStyleCamera::OnEvent(vtkObject* caller, unsigned long eid, void* callData) 
+vtkWiiMoteStyleCamera::~vtkWiiMoteStyleCamera() 
 {
-  // Need to initialize both here, as they cannot be initialized in the case statement
-  vtkVRPNAnalog* analog = static_cast<vtkVRPNAnalog*>(caller);
-  vtkVRPNButton* button = static_cast<vtkVRPNButton*>(caller);
-
-  switch(eid)
-    {
-    case vtkVRPNDevice::AnalogEvent:
-      this->OnAnalog(analog);
-      break;
-
-    case vtkVRPNDevice::ButtonEvent:
-      this->OnButton(button);
-      break;
-    }
+  this->PanInertia->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -97,6 +86,7 @@ void vtkWiiMoteStyleCamera::OnButton(vtkVRPNButton* button)
 
     if (this->AnalogOutput) this->AnalogOutput->SetChannel(0, 1.0);
 
+    this->Interact();
     this->HomeDown = true;
     }
   else 
@@ -113,33 +103,51 @@ void vtkWiiMoteStyleCamera::OnButton(vtkVRPNButton* button)
     {
     // Zoom out
     camera->Dolly(1.0 - this->ZoomSensitivity);
+    this->Interact();
     } 
   else if (button->GetButton(vtkWiiMoteStyle::ButtonPlus))
     {
     // Zoom in
     camera->Dolly(1.0 + this->ZoomSensitivity);
+    this->Interact();
     }
 
   // Pan
+  double pan[3] = { 0.0, 0.0, 0.0 };
   if (button->GetButton(vtkWiiMoteStyle::ButtonLeft))
     {
     // Pan left
-    this->Pan(-1.0, 0.0);
+    pan[0] = -1.0;
     }
   else if (button->GetButton(vtkWiiMoteStyle::ButtonRight))
     {
     // Pan right
-    this->Pan(1.0, 0.0);
+    pan[0] = 1.0;
     }
   else if (button->GetButton(vtkWiiMoteStyle::ButtonDown))
     {
     // Pan down
-    this->Pan(0.0, -1.0);
+    pan[1] = -1.0;
     }
   else if (button->GetButton(vtkWiiMoteStyle::ButtonUp))
     {
     // Pan up
-    this->Pan(0.0, 1.0);
+    pan[1] = 1.0;
+    }
+
+  if (pan[0] != 0.0 || pan[1] != 0.0)
+    {
+    this->Pan(pan[0], pan[1]);
+    this->PanInertia->AddMotion(pan, vtkTimerLog::GetUniversalTime());
+
+    this->PanDown = true;
+    }
+  else if (this->PanDown)
+    {
+    // Coast on after the pan button is released
+    this->PanInertia->Release(vtkTimerLog::GetUniversalTime());
+
+    this->PanDown = false;
     }
 
   // Rotate
@@ -158,6 +166,7 @@ void vtkWiiMoteStyleCamera::OnButton(vtkVRPNButton* button)
 //    camera->Roll(-(this->ZGravity - this->OldZGravity) * this->RotateSensitivity);
     camera->OrthogonalizeViewUp();
 
+    this->Interact();
     this->TriggerDown = true;
     }
   else
@@ -169,18 +178,30 @@ void vtkWiiMoteStyleCamera::OnButton(vtkVRPNButton* button)
   // Render() will be called in the interactor
 }
 
+//----------------------------------------------------------------------------
+void vtkWiiMoteStyleCamera::EndFrame()
+{
+  double motion[3];
+  if (this->PanInertia->Advance(vtkTimerLog::GetUniversalTime(), motion))
+    {
+    this->Pan(motion[0], motion[1]);
+    this->Renderer->ResetCameraClippingRange();
+    }
+
+  this->Superclass::EndFrame();
+}
+
 //----------------------------------------------------------------------------
 void vtkWiiMoteStyleCamera::Pan(double xDelta, double yDelta)
 {
   vtkCamera* camera = this->Renderer->GetActiveCamera();
 
+  vtkDeviceViewTransform* view = this->GetViewTransform();
   double viewFocus[4], focalDepth, viewPoint[3];
   double newPickPoint[4], oldPickPoint[4], motionVector[3];
 
   camera->GetFocalPoint(viewFocus);
-  vtkInteractorObserver::ComputeWorldToDisplay(this->Renderer, 
-                                               viewFocus[0], viewFocus[1], viewFocus[2], 
-                                               viewFocus);
+  view->WorldToDisplay(viewFocus[0], viewFocus[1], viewFocus[2], viewFocus);
   focalDepth = viewFocus[2];
 
   // Normalize for window size
@@ -189,13 +210,9 @@ void vtkWiiMoteStyleCamera::Pan(double xDelta, double yDelta)
   xDelta *= width * this->PanSensitivity;
   yDelta *= height * this->PanSensitivity;
 
-  vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer, 
-                                               xDelta, yDelta, focalDepth, 
-                                               newPickPoint);
+  view->DisplayToWorld(xDelta, yDelta, focalDepth, newPickPoint);
 
-  vtkInteractorObserver::ComputeDisplayToWorld(this->Renderer, 
-                                               0, 0, focalDepth, 
-                                               oldPickPoint);
+  view->DisplayToWorld(0, 0, focalDepth, oldPickPoint);
 
   // Camera motion is reversed
   motionVector[0] = newPickPoint[0] - oldPickPoint[0];
@@ -211,6 +228,8 @@ void vtkWiiMoteStyleCamera::Pan(double xDelta, double yDelta)
   camera->SetPosition(motionVector[0] + viewPoint[0],
                       motionVector[1] + viewPoint[1],
                       motionVector[2] + viewPoint[2]);
+
+  this->Interact();
 }
 
 //----------------------------------------------------------------------------
@@ -229,4 +248,7 @@ void vtkWiiMoteStyleCamera::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "OldZGravity: " << this->OldZGravity << "\n";
   os << indent << "TriggerDown: " << this->TriggerDown << "\n";
   os << indent << "HomeDown: " << this->HomeDown << "\n";
+  os << indent << "PanDown: " << this->PanDown << "\n";
+  os << indent << "PanInertia:\n";
+  this->PanInertia->PrintSelf(os,indent.GetNextIndent());
 }
\ No newline at end of file
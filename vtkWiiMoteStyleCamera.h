@@ -19,6 +19,9 @@
 // button events generated by a WiiMote using the Virtual Reality 
 // Peripheral Network (VRPN: http://www.cs.unc.edu/Research/vrpn/).  
 //
+// Pans coast on after the pan button is released, slowing down with the 
+// damping of PanInertia.
+//
 // .SECTION see also
 // vtkDeviceInteractor vtkInteractionDevice
 
@@ -29,6 +32,8 @@
 
 #include "vtkWiiMOteStyle.h"
 
+class vtkDeviceInertia;
+
 class VTK_INTERACTIONDEVICE_EXPORT vtkWiiMoteStyleCamera : public vtkWiiMoteStyle
 {
 public:
@@ -36,10 +41,6 @@ public:
   vtkTypeRevisionMacro(vtkWiiMoteStyleCamera,vtkWiiMoteStyle);
   void PrintSelf(ostream&, vtkIndent); 
 
-  // Description:
-  // Perform interaction based on an event
-  virtual void OnEvent(vtkObject* caller, unsigned long eid, void* callData);
-
   // Description:
   // Set/get sensitivity parameters
   vtkSetMacro(ZoomSensitivity,double);
@@ -49,6 +50,14 @@ public:
   vtkSetMacro(RotateSensitivity,double);
   vtkGetMacro(RotateSensitivity,double);
 
+  // Description:
+  // Get the inertia of pans, in pan steps
+  vtkGetObjectMacro(PanInertia,vtkDeviceInertia);
+
+  // Description:
+  // Coast the camera
+  virtual void EndFrame();
+
 protected:
   vtkWiiMoteStyleCamera();
   ~vtkWiiMoteStyleCamera();
@@ -69,6 +78,9 @@ protected:
 
   bool TriggerDown;
   bool HomeDown;
+  bool PanDown;
+
+  vtkDeviceInertia* PanInertia;
 
   // Description:
   // Perform a pan interaction
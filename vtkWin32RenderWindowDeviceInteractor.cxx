@@ -19,6 +19,7 @@
 #include "vtkCommand.h"
 #include "vtkDeviceInteractor.h"
 #include "vtkObjectFactory.h"
+#include "vtksys/SystemTools.hxx"
 
 #ifndef VTK_IMPLEMENT_MESA_CXX
 vtkCxxRevisionMacro(vtkWin32RenderWindowDeviceInteractor, "$Revision: 1.0 $");
@@ -66,11 +67,34 @@ void vtkWin32RenderWindowDeviceInteractor::Start()
     TranslateMessage(&msg);
     DispatchMessage(&msg);
 
-    // Receive updates from interaction devices
+    // Invoke device events with the newest state once the frame is due, 
+    // then render it, or refine once idle
     if (this->DeviceInteractor) 
       {
-      this->DeviceInteractor->Update();
-      this->Render();
+      if (this->DeviceInteractor->IsFrameDue())
+        {
+        this->DeviceInteractor->Update();
+
+        if (this->DeviceInteractor->IsRenderDue(this->RenderWindow))
+          {
+          this->DeviceInteractor->StartRender(this->RenderWindow);
+          this->Render();
+          this->DeviceInteractor->EndRender();
+          }
+        }
+      else if (this->DeviceInteractor->IsRefinementDue())
+        {
+        this->DeviceInteractor->StartRefinement(this->RenderWindow);
+        this->Render();
+        this->DeviceInteractor->EndRefinement();
+        }
+      else
+        {
+        // Only receive input between frames, so styles run once per 
+        // frame, and don't spin
+        this->DeviceInteractor->Poll();
+        vtksys::SystemTools::Delay(1);
+        }
       }
     }
 }